@@ -0,0 +1,174 @@
+#ifndef ARENA_H
+#define ARENA_H
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace bao {
+    /**
+     * Bump allocator, everything allocated from it is released at once when
+     * the arena is destroyed. Objects that need their destructor have it run
+     * then, newest first
+     */
+    class Arena {
+        static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+        struct Destructor {
+            void (*destroy)(void*);
+            void* object;
+        };
+
+        std::vector<std::unique_ptr<std::byte[]>> chunks;
+        std::byte* cursor = nullptr; // Free space of the newest chunk
+        std::byte* limit = nullptr;
+        size_t allocated = 0; // Bytes handed out
+        std::vector<Destructor> destructors;
+
+    public:
+        Arena() = default;
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        // The chunks stay where they are, so objects outlive a move of their arena
+        Arena(Arena&& other) noexcept
+            : chunks(std::move(other.chunks)),
+              cursor(std::exchange(other.cursor, nullptr)),
+              limit(std::exchange(other.limit, nullptr)),
+              allocated(std::exchange(other.allocated, 0)),
+              destructors(std::move(other.destructors)) {}
+
+        Arena& operator=(Arena&& other) noexcept {
+            if (this != &other) {
+                this->release();
+                chunks = std::move(other.chunks);
+                cursor = std::exchange(other.cursor, nullptr);
+                limit = std::exchange(other.limit, nullptr);
+                allocated = std::exchange(other.allocated, 0);
+                destructors = std::move(other.destructors);
+            }
+            return *this;
+        }
+
+        ~Arena() {
+            this->release();
+        }
+
+        /**
+         *
+         * @param size Size in bytes
+         * @param alignment Alignment, a power of two
+         * @return Uninitialized memory, valid as long as the arena
+         */
+        void* allocate(const size_t size, const size_t alignment) {
+            auto address = reinterpret_cast<uintptr_t>(cursor);
+            uintptr_t aligned = (address + alignment - 1) & ~(alignment - 1);
+            if (!cursor || aligned + size > reinterpret_cast<uintptr_t>(limit)) {
+                // Large requests get a chunk of their own
+                const size_t chunk_size = std::max(CHUNK_SIZE, size + alignment);
+                chunks.push_back(std::make_unique_for_overwrite<std::byte[]>(chunk_size));
+                cursor = chunks.back().get();
+                limit = cursor + chunk_size;
+                address = reinterpret_cast<uintptr_t>(cursor);
+                aligned = (address + alignment - 1) & ~(alignment - 1);
+            }
+            cursor = reinterpret_cast<std::byte*>(aligned + size);
+            allocated += size;
+            return reinterpret_cast<void*>(aligned);
+        }
+
+        /**
+         * Construct an object in the arena
+         * @param args Arguments of T's constructor
+         * @return The object, owned by the arena
+         */
+        template<typename T, typename... Args>
+        T* make(Args&&... args) {
+            T* object = new (this->allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                destructors.push_back({[](void* pointer) { static_cast<T*>(pointer)->~T(); }, object});
+            }
+            return object;
+        }
+
+        /**
+         *
+         * @param items Items to copy
+         * @return A copy of the items in the arena
+         */
+        template<typename T>
+        std::span<T> copy(const std::vector<T>& items) {
+            static_assert(std::is_trivially_copyable_v<T>, "Chỉ sao chép được kiểu sao chép tầm thường vào vùng nhớ");
+            if (items.empty()) {
+                return {};
+            }
+            auto* copied = static_cast<T*>(this->allocate(sizeof(T) * items.size(), alignof(T)));
+            std::memcpy(copied, items.data(), sizeof(T) * items.size());
+            return {copied, items.size()};
+        }
+
+        /**
+         *
+         * @param text Text to copy
+         * @return A copy of the text in the arena
+         */
+        std::string_view copy(const std::string_view text) {
+            if (text.empty()) {
+                return {};
+            }
+            auto* copied = static_cast<char*>(this->allocate(text.size(), 1));
+            std::memcpy(copied, text.data(), text.size());
+            return {copied, text.size()};
+        }
+
+        /**
+         * Take over everything allocated from another arena, which is left empty.
+         * Its objects stay where they are and are destroyed before this arena's
+         * @param other Arena to take over
+         */
+        void absorb(Arena&& other) {
+            if (this == &other) {
+                return;
+            }
+            // Keep allocating from the newest chunk of this arena, it may have room left
+            chunks.insert(chunks.begin(),
+                          std::make_move_iterator(other.chunks.begin()),
+                          std::make_move_iterator(other.chunks.end()));
+            destructors.insert(destructors.end(), other.destructors.begin(), other.destructors.end());
+            allocated += other.allocated;
+            other.chunks.clear();
+            other.destructors.clear();
+            other.cursor = nullptr;
+            other.limit = nullptr;
+            other.allocated = 0;
+        }
+
+        /**
+         *
+         * @return Bytes handed out so far
+         */
+        [[nodiscard]] size_t size() const {
+            return allocated;
+        }
+
+    private:
+        void release() {
+            for (auto it = destructors.rbegin(); it != destructors.rend(); ++it) {
+                it->destroy(it->object);
+            }
+            destructors.clear();
+            chunks.clear();
+            cursor = nullptr;
+            limit = nullptr;
+            allocated = 0;
+        }
+    };
+}
+#endif //ARENA_H
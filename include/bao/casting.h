@@ -0,0 +1,40 @@
+#ifndef CASTING_H
+#define CASTING_H
+#include <type_traits>
+
+// Checked downcasts over the kind tag of AST nodes, MIR instructions and types.
+// A class T can be cast to when it has a static T::KIND, and its base a get_kind()
+namespace bao {
+    /**
+     *
+     * @param node Node to test, may be null
+     * @return Whether the node is a T
+     */
+    template<typename T, typename From>
+    bool isa(const From* node) {
+        return node && node->get_kind() == T::KIND;
+    }
+
+    /**
+     * Downcast a node known to be a T
+     * @param node A T
+     * @return The node as a T
+     */
+    template<typename T, typename From>
+    auto cast(From* node) {
+        using Target = std::conditional_t<std::is_const_v<From>, const T, T>;
+        return static_cast<Target*>(node);
+    }
+
+    /**
+     *
+     * @param node Node to cast, may be null
+     * @return The node as a T, null if it is not one
+     */
+    template<typename T, typename From>
+    auto dyn_cast(From* node) {
+        using Target = std::conditional_t<std::is_const_v<From>, const T, T>;
+        return isa<T>(node) ? static_cast<Target*>(node) : nullptr;
+    }
+}
+#endif //CASTING_H
@@ -7,6 +7,7 @@
 #include <llvm/IR/Module.h>
 #include <llvm/IR/IRBuilder.h>
 #include <unordered_map>
+#include <vector>
 
 namespace bao {
     class Generator {
@@ -14,7 +15,8 @@ namespace bao {
         llvm::LLVMContext context;
         llvm::Module llvm_module;
         llvm::IRBuilder<> ir_builder;
-        std::unordered_map<std::string, llvm::Value*> current_context;
+        std::unordered_map<Symbol, llvm::Value*> current_context; // Variables, keyed by the interned name
+        std::vector<llvm::Value*> current_temporaries; // Temporaries, by their index in the function
 
     public:
         Generator(bao::mir::Module&& mir_module);
@@ -0,0 +1,77 @@
+#ifndef BUFFER_H
+#define BUFFER_H
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+using std::string;
+
+namespace bao {
+    /**
+     * Source text handed to the lexer, either a read-only view of a
+     * memory-mapped file or an owned (normalized) copy
+     */
+    class SourceBuffer {
+        const char* data = nullptr;
+        size_t size = 0;
+        string owned;
+        bool mapped = false;
+        bool validated = false;
+    public:
+        SourceBuffer() = default;
+        SourceBuffer(const SourceBuffer&) = delete;
+        SourceBuffer& operator=(const SourceBuffer&) = delete;
+        SourceBuffer(SourceBuffer&& other) noexcept;
+        SourceBuffer& operator=(SourceBuffer&& other) noexcept;
+        ~SourceBuffer();
+
+        /**
+         * Map a file into memory without copying it
+         * @param path Full path of the file
+         * @return A buffer viewing the mapped bytes
+         */
+        static SourceBuffer map_file(const string& path);
+
+        /**
+         *
+         * @param content Content the buffer takes ownership of
+         * @return A buffer owning the content
+         */
+        static SourceBuffer from_string(string content);
+
+        /**
+         *
+         * @return The bytes of the buffer
+         */
+        [[nodiscard]] std::string_view view() const {
+            return {data, size};
+        }
+
+        /**
+         *
+         * @return Whether the buffer still points into the mapped file
+         */
+        [[nodiscard]] bool is_mapped() const {
+            return mapped;
+        }
+
+        /**
+         *
+         * @return Whether the bytes are known to be well-formed UTF-8
+         */
+        [[nodiscard]] bool is_validated() const {
+            return validated;
+        }
+
+        /**
+         * Records that the bytes passed UTF-8 validation, so later stages can decode unchecked
+         */
+        void mark_validated() {
+            validated = true;
+        }
+
+    private:
+        void release();
+    };
+}
+#endif //BUFFER_H
@@ -0,0 +1,114 @@
+#ifndef MANAGER_H
+#define MANAGER_H
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <bao/filereader/buffer.h>
+
+using std::string;
+using std::vector;
+
+namespace bao {
+    using FileId = uint32_t;
+
+    /**
+     * Owns every loaded source buffer once and answers line lookups
+     * for diagnostics without touching the disk again
+     */
+    class SourceManager {
+        struct File {
+            string path;
+            SourceBuffer buffer;
+            vector<uint32_t> line_starts; // Byte offset of the start of every line
+            // What the file looked like on disk when it was loaded
+            uintmax_t size = 0;
+            std::filesystem::file_time_type modified;
+        };
+
+        // Errors can be raised from several threads at once
+        mutable std::shared_mutex mutex;
+        vector<std::unique_ptr<File>> files;
+        std::unordered_map<string, FileId> ids;
+    public:
+        SourceManager() = default;
+        SourceManager(const SourceManager&) = delete;
+        SourceManager& operator=(const SourceManager&) = delete;
+
+        /**
+         *
+         * @return The manager shared by the whole compilation
+         */
+        static SourceManager& global();
+
+        /**
+         * Loads a file the first time it is asked for, and again once it changed on disk.
+         * A reloaded file gets a new id, the ids handed out before keep their content
+         * @param path Path of the source file
+         * @return The id of the file as it is now
+         */
+        FileId load(const string& path);
+
+        /**
+         *
+         * @param id File id
+         * @return The normalized content of the file
+         */
+        [[nodiscard]] std::string_view get_buffer(FileId id) const;
+
+        /**
+         *
+         * @param id File id
+         * @return Whether the content is known to be well-formed UTF-8
+         */
+        [[nodiscard]] bool is_validated(FileId id) const;
+
+        /**
+         *
+         * @param id File id
+         * @return The full path of the file
+         */
+        [[nodiscard]] const string& get_path(FileId id) const;
+
+        /**
+         *
+         * @param id File id
+         * @param line 1-based line number
+         * @return Text of the line without its line break
+         */
+        [[nodiscard]] std::string_view get_line(FileId id, int line) const;
+
+        /**
+         * Same as get_line(FileId, int) but loads the file on demand, so the line
+         * comes from the file as it is now
+         * @param path Path of the source file
+         * @param line 1-based line number
+         * @return Text of the line without its line break
+         */
+        std::string_view get_line(const string& path, int line);
+
+        /**
+         *
+         * @param id File id
+         * @param offset Byte offset into the file
+         * @return 1-based line and column (in code points) of the offset
+         */
+        [[nodiscard]] std::pair<int, int> line_column(FileId id, size_t offset) const;
+
+        /**
+         *
+         * @param id File id
+         * @return Number of line starts in the file
+         */
+        [[nodiscard]] size_t line_count(FileId id) const;
+
+    private:
+        [[nodiscard]] const File& get_file(FileId id) const;
+    };
+}
+#endif //MANAGER_H
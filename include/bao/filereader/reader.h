@@ -5,6 +5,8 @@
 #ifndef READER_H
 #define READER_H
 #include <string>
+#include <string_view>
+#include <bao/filereader/buffer.h>
 
 using std::string;
 
@@ -25,6 +27,12 @@ namespace bao {
          */
         [[nodiscard]] string read() const;
 
+        /**
+         * Memory-maps the file and only copies it when it is not already NFC
+         * @return The normalized content, viewing the mapping when possible
+         */
+        [[nodiscard]] SourceBuffer map() const;
+
         /**
          *
          * @param line Line to get bro
@@ -35,10 +43,30 @@ namespace bao {
     private:
         /**
          *
+         * @return The full path of the source file, checked for existence
+         */
+        [[nodiscard]] string resolve() const;
+
+        /**
+         * Rejects malformed UTF-8 before anything tries to decode it
+         * @param content Raw content of the file
+         */
+        void validate(std::string_view content) const;
+
+        /**
+         *
+         * @param content UTF-8 content to scan
+         * @return Length of the longest prefix that is NFC and ends on a normalization boundary
+         */
+        [[nodiscard]] static size_t nfc_span(std::string_view content);
+
+        /**
+         * Normalizes to NFC, splitting large content at line breaks
+         * and normalizing the pieces in parallel
          * @param content The string content that needs to be normalized
          * @return The normalized string
          */
-        [[nodiscard]] static string normalize(const string& content) ;
+        [[nodiscard]] static string normalize(std::string_view content);
     };
 }
 #endif //READER_H
@@ -0,0 +1,30 @@
+#ifndef UTF8_H
+#define UTF8_H
+#include <cstddef>
+#include <string_view>
+#include <utility>
+
+namespace bao::utf8 {
+    /**
+     * Validates UTF-8 with AVX2 or SSE2 when available
+     * @param text Bytes to check
+     * @return Offset of the first invalid sequence, text.size() if it is all valid
+     */
+    size_t validate(std::string_view text);
+
+    /**
+     * Byte by byte version of validate(), kept as the fallback and for benchmarks
+     * @param text Bytes to check
+     * @return Offset of the first invalid sequence, text.size() if it is all valid
+     */
+    size_t validate_scalar(std::string_view text);
+
+    /**
+     *
+     * @param text UTF-8 text
+     * @param offset Byte offset into the text
+     * @return 1-based line and column (in code points) of the offset
+     */
+    std::pair<int, int> locate(std::string_view text, size_t offset);
+}
+#endif //UTF8_H
@@ -0,0 +1,63 @@
+#ifndef INTERNER_H
+#define INTERNER_H
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bao {
+    /**
+     * Id of an interned name, equal names always get the same id
+     */
+    enum class Symbol : uint32_t {};
+
+    /**
+     * Maps every distinct name to a Symbol once. Split into shards with a
+     * lock each, so lexers running in parallel rarely wait on each other
+     */
+    class Interner {
+        static constexpr uint32_t SHARD_BITS = 6;
+        static constexpr uint32_t SHARDS = 1u << SHARD_BITS;
+
+        // Open addressing over the hash the shard was picked with, so a name is hashed once
+        struct Shard {
+            mutable std::mutex mutex;
+            std::deque<std::string> names; // Indexed by the local part of the symbol
+            std::vector<size_t> hashes; // Hash of every name
+            std::vector<uint32_t> slots; // Local index + 1, 0 when empty
+        };
+
+        std::array<Shard, SHARDS> shards;
+    public:
+        // Symbol of no name
+        static constexpr Symbol NONE = Symbol{UINT32_MAX};
+
+        Interner() = default;
+        Interner(const Interner&) = delete;
+        Interner& operator=(const Interner&) = delete;
+
+        /**
+         *
+         * @return The interner shared by the whole compilation
+         */
+        static Interner& global();
+
+        /**
+         *
+         * @param name Name to intern
+         * @return Its symbol, the same for every call with an equal name
+         */
+        Symbol intern(std::string_view name);
+
+        /**
+         *
+         * @param symbol A symbol of this interner
+         * @return The name it was interned from, valid as long as the interner
+         */
+        [[nodiscard]] std::string_view name(Symbol symbol) const;
+    };
+}
+#endif //INTERNER_H
@@ -6,48 +6,186 @@
 #define LEXER_H
 #include <exception>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <unicode/unistr.h>
-#include <unicode/schriter.h>
+#include <unicode/umachine.h>
 #include <bao/lexer/token.h>
+#include <bao/parallel.h>
 
 using std::string;
 using std::vector;
 using std::exception;
-using icu::UnicodeString;
-using icu::StringCharacterIterator;
 using std::exception_ptr;
 
 namespace bao {
+    /**
+     * A byte range of a source replaced by new text
+     */
+    struct Edit {
+        size_t offset; // Where the range starts
+        size_t removed; // Length of the range in the old source
+        size_t inserted; // Length of the new text
+    };
+
     class Lexer {
         vector<exception_ptr> exceptions;
 
-        UnicodeString source;
-        StringCharacterIterator it;
-        int code_point_index;
-        vector<Token> tokens;
+        std::string_view source;
+        bool validated; // Well-formed UTF-8 can be decoded without checks
+        size_t offset; // Byte offset of the current code point
+        size_t next_offset; // Byte offset of the code point after it
+        UChar32 code_point; // The current code point
+        size_t whitespace_end = 0; // End of the whitespace run being split into newline tokens
+        bool open_comment = false; // Whether a block comment ran to the end of the source
+        TokenList tokens; // Line starts, and every token once tokenize() ran
         int current_line;
-        int current_column;
 
     public:
-        explicit Lexer(const string &source);
+        /**
+         *
+         * @param source UTF-8 source, which has to outlive the lexer
+         * @param validated Whether the source already passed utf8::validate()
+         */
+        explicit Lexer(std::string_view source, bool validated = false);
+
+    private:
+        /**
+         * Lexer of the part of a source from a line start to its end
+         * @param source The source, up to the end of the part
+         * @param validated Whether the source already passed utf8::validate()
+         * @param begin Byte offset of the line the part starts at
+         * @param first_line 1-based number of that line
+         */
+        Lexer(std::string_view source, bool validated, size_t begin, int first_line);
 
+    public:
+        /**
+         * Collapse every line break and the blank and comment-only lines after it into one Newline token
+         * @param enabled Whether to collapse, off by default
+         */
+        void set_collapse_newlines(const bool enabled) {
+            tokens.collapsed = enabled;
+        }
+
+        /**
+         * Lex the whole source into the token list, mostly for tests
+         */
         void tokenize();
 
-        [[nodiscard]] const vector<Token> &get_tokens() const;
+        /**
+         * Same tokens as tokenize(), with the source cut before top-level declarations
+         * and the parts lexed concurrently. Small sources are lexed sequentially
+         * @param threads Upper bound of threads to use
+         */
+        void tokenize_parallel(unsigned threads = parallel::worker_count());
+
+        /**
+         *
+         * @return Every token, throws the errors met while lexing
+         */
+        [[nodiscard]] const TokenList &get_tokens() const;
+
+        /**
+         *
+         * @return The lines lexed so far, and every token once tokenize() ran, errors or not
+         */
+        [[nodiscard]] const TokenList &get_lexed() const {
+            return tokens;
+        }
+
+        /**
+         * Update the tokens of a source after an edit. Lexing restarts at the line of
+         * the edit and stops as soon as a token lines up with an old one, the tokens
+         * after it are only moved. Throws the errors met in the re-lexed part
+         * @param tokens Tokens of the whole old source, from tokenize()
+         * @param source The edited source, which has to outlive the tokens
+         * @param edit Where the old source was edited
+         * @param validated Whether the edited source already passed utf8::validate()
+         */
+        static void relex(TokenList& tokens, std::string_view source, const Edit& edit, bool validated = false);
+
+        /**
+         * Lex one more token, the lexer only moves forward when asked
+         * @return The next token, EndOfFile once the source is exhausted
+         */
+        Token next_token();
+
+        /**
+         *
+         * @param token A token of this lexer
+         * @return The text of the token
+         */
+        [[nodiscard]] std::string_view text(const Token& token) const {
+            return tokens.text(token);
+        }
+
+        /**
+         *
+         * @param token A token of this lexer, lexed already
+         * @return 1-based column of the token, in code points
+         */
+        [[nodiscard]] int column(const Token& token) const {
+            return tokens.column(token);
+        }
+
+        /**
+         *
+         * @param token A token of this lexer, lexed already
+         * @param from_offset Byte offset of a code point of the token's line, at or before the token
+         * @param from_column Column of that code point
+         * @return 1-based column of the token, in code points
+         */
+        [[nodiscard]] int column(const Token& token, const uint32_t from_offset, const int from_column) const {
+            return tokens.column(token, from_offset, from_column);
+        }
+
+        /**
+         *
+         * @return Errors met so far
+         */
+        [[nodiscard]] const vector<exception_ptr> &get_errors() const {
+            return exceptions;
+        }
 
     private:
-        [[nodiscard]] string current_utf8() const;
+        [[nodiscard]] std::string_view current_bytes() const;
+
+        /**
+         *
+         * @param type Type of the token
+         * @param start Byte offset the token starts at, it ends at the current position
+         * @param id Keyword or Operator of the token, Symbol of an identifier
+         * @return The token
+         */
+        [[nodiscard]] Token make_token(TokenType type, size_t start, uint32_t id = 0) const;
+
+        [[nodiscard]] UChar32 current_code_point() const {
+            return code_point;
+        }
 
-        [[nodiscard]] UChar32 current_code_point() const;
+        [[nodiscard]] bool has_next() const {
+            return offset < source.size();
+        }
 
-        [[nodiscard]] string peek() const;
+        [[nodiscard]] UChar32 decode(size_t at, size_t &end) const;
+
+        [[nodiscard]] std::string_view peek() const;
 
         void next();
 
-        void skip_whitespace();
+        void advance_ascii(size_t end);
+
+        void skip_word();
+
+        void seek(size_t byte_offset);
+
+        void skip_to(size_t end);
+
+        [[nodiscard]] size_t comment_end() const;
+
+        void skip_blank_lines(size_t newline);
 
-        void seek(int code_point_index);
+        Token lex_token();
 
         Token handle_identifier();
 
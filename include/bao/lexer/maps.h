@@ -5,18 +5,51 @@
 #ifndef MAPS_H
 #define MAPS_H
 
-#include <unordered_map>
-#include <string>
-
-using std::string;
+#include <array>
+#include <string_view>
+#include <bao/phf.h>
+#include <bao/lexer/token.h>
 
 namespace bao {
-    struct Token;
-    enum class Primitive;
-    enum class TokenType;
-    extern const std::unordered_map<TokenType, string> token_type_map;
-    extern const std::unordered_map<string, Token> token_map;
-    extern const std::unordered_map<string, Primitive> primitive_map;
+    // Indexed by TokenType
+    constexpr std::array<std::string_view, 16> token_type_map = {
+        "Operator",
+        "Identifier",
+        "Keyword",
+        "Literal",
+        "String",
+        "Semicolon",
+        "Comma",
+        "LParen",
+        "RParen",
+        "LBracket",
+        "RBracket",
+        "LBrace",
+        "RBrace",
+        "Newline",
+        "EndOfFile",
+        "Unknown"
+    };
+    static_assert(token_type_map.size() == static_cast<size_t>(TokenType::Unknown) + 1);
+
+    /**
+     *
+     * @param type Token type
+     * @return Name of the token type
+     */
+    constexpr std::string_view token_type_name(TokenType type) {
+        return token_type_map[static_cast<size_t>(type)];
+    }
+
+    // Single-character tokens, the token's value is the key itself
+    constexpr auto token_map = phf::make_map<TokenType>({
+        {"(", TokenType::LParen},
+        {")", TokenType::RParen},
+        {"[", TokenType::LBracket},
+        {"]", TokenType::RBracket},
+        {";", TokenType::Semicolon},
+        {",", TokenType::Comma},
+    });
 }
 
 #endif //MAPS_H
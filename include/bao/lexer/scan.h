@@ -0,0 +1,33 @@
+#ifndef SCAN_H
+#define SCAN_H
+#include <cstddef>
+#include <string_view>
+
+// Runs of ASCII bytes the lexer can consume without decoding, scanned
+// 32 or 16 bytes at a time. Every run stops at the first non-ASCII byte.
+namespace bao::scan {
+    /**
+     *
+     * @param text Source bytes
+     * @param from Offset to start from
+     * @return Offset of the first byte that is not ' ' or '\n'
+     */
+    size_t whitespace(std::string_view text, size_t from);
+
+    /**
+     *
+     * @param text Source bytes
+     * @param from Offset to start from
+     * @return Offset of the first byte that is not an ASCII letter, digit or '_'
+     */
+    size_t identifier(std::string_view text, size_t from);
+
+    /**
+     *
+     * @param text Source bytes
+     * @param from Offset to start from
+     * @return Offset of the first byte that is not an ASCII digit
+     */
+    size_t digits(std::string_view text, size_t from);
+}
+#endif //SCAN_H
@@ -4,18 +4,32 @@
 
 #ifndef SYMBOLS_H
 #define SYMBOLS_H
-#include <unordered_set>
-#include <string>
-
-using std::string;
+#include <bao/phf.h>
+#include <bao/lexer/token.h>
 
 namespace bao {
-    inline std::unordered_set<string> operators = {
-        "+", "-", "*", "/", "=", "!=", ":=", ">", "<", ">=", "<=", "..", "->", ":"
-    };
-    inline std::unordered_set<string> keywords = {
+    constexpr auto operators = phf::make_map<Operator>({
+        {"+", Operator::Plus},
+        {"-", Operator::Minus},
+        {"*", Operator::Star},
+        {"/", Operator::Slash},
+        {"=", Operator::Equal},
+        {"!=", Operator::NotEqual},
+        {":=", Operator::Assign},
+        {">", Operator::Greater},
+        {"<", Operator::Less},
+        {">=", Operator::GreaterEqual},
+        {"<=", Operator::LessEqual},
+        {"..", Operator::Range},
+        {"->", Operator::Arrow},
+        {":", Operator::Colon},
+    });
+    // The index of a keyword is its Keyword
+    constexpr phf::Set keywords({
         "hàm", "thủ tục", "nếu", "thì", "không thì", "và", "hoặc", "kết thúc", "trả về"
-    };
+    });
+    static_assert(keywords.keys().size() == static_cast<size_t>(Keyword::Return) + 1);
+    static_assert(keywords.keys()[static_cast<size_t>(Keyword::End)] == "kết thúc");
 }
 
 #endif //SYMBOLS_H
@@ -4,10 +4,14 @@
 
 #ifndef TOKEN_H
 #define TOKEN_H
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <vector>
 using std::string;
+using std::vector;
 namespace bao {
-    enum class TokenType {
+    enum class TokenType : uint8_t {
         Operator,
         Identifier,
         Keyword,
@@ -26,11 +30,162 @@ namespace bao {
         Unknown
     };
 
+    // Keywords, in the order of bao::keywords
+    enum class Keyword : uint8_t {
+        Function, // hàm
+        Procedure, // thủ tục
+        If, // nếu
+        Then, // thì
+        Else, // không thì
+        And, // và
+        Or, // hoặc
+        End, // kết thúc
+        Return, // trả về
+    };
+
+    // Operators, the keys of bao::operators
+    enum class Operator : uint8_t {
+        Plus, // +
+        Minus, // -
+        Star, // *
+        Slash, // /
+        Equal, // =
+        NotEqual, // !=
+        Assign, // :=
+        Greater, // >
+        Less, // <
+        GreaterEqual, // >=
+        LessEqual, // <=
+        Range, // ..
+        Arrow, // ->
+        Colon, // :
+        Of, // E, between a variable and its type
+    };
+
+    /**
+     * A span of the source, its text and column are looked up through the TokenList
+     */
     struct Token {
         TokenType type;
-        string value;
-        int line;
-        int column;
+        uint16_t length; // Length in bytes
+        uint32_t offset; // Byte offset in the source
+        uint32_t line; // 1-based line
+        uint32_t id; // Keyword or Operator of the token, the Symbol of an identifier, 0 for other tokens
+
+        [[nodiscard]] bool is(const Keyword keyword) const {
+            return type == TokenType::Keyword && id == static_cast<uint32_t>(keyword);
+        }
+
+        [[nodiscard]] bool is(const Operator op) const {
+            return type == TokenType::Operator && id == static_cast<uint32_t>(op);
+        }
+
+        // Field by field, the padding after the type is indeterminate
+        bool operator==(const Token&) const = default;
+    };
+    static_assert(sizeof(Token) == 16);
+
+    /**
+     * Tokens of one source, which has to outlive the list
+     */
+    class TokenList {
+        friend class Lexer; // Splices re-lexed parts in
+
+        std::string_view source;
+        vector<Token> tokens;
+        vector<uint32_t> line_starts; // Byte offset of the start of every line
+        bool collapsed = false; // Whether a Newline token covers the blank and comment-only lines after it
+    public:
+        explicit TokenList(const std::string_view source = {}) : source(source), line_starts{0} {}
+
+        void push_back(const Token& token) {
+            tokens.push_back(token);
+        }
+
+        /**
+         * Records that a new line starts at a byte offset
+         * @param start Byte offset right after a line break
+         */
+        void add_line(const uint32_t start) {
+            line_starts.push_back(start);
+        }
+
+        /**
+         * Appends a list lexed from the part of the same source that follows this one
+         * @param chunk Tokens of the next part, without the end of file token of this list
+         */
+        void append(const TokenList& chunk) {
+            tokens.insert(tokens.end(), chunk.tokens.begin(), chunk.tokens.end());
+            // Its first line starts where the last line of this list does
+            line_starts.insert(line_starts.end(), chunk.line_starts.begin() + 1, chunk.line_starts.end());
+        }
+
+        void reserve(const size_t count) {
+            tokens.reserve(count);
+        }
+
+        void pop_back() {
+            tokens.pop_back();
+        }
+
+        [[nodiscard]] size_t size() const {
+            return tokens.size();
+        }
+
+        [[nodiscard]] const Token& operator[](const size_t index) const {
+            return tokens[index];
+        }
+
+        [[nodiscard]] auto begin() const {
+            return tokens.begin();
+        }
+
+        [[nodiscard]] auto end() const {
+            return tokens.end();
+        }
+
+        [[nodiscard]] bool collapses_newlines() const {
+            return collapsed;
+        }
+
+        [[nodiscard]] std::string_view get_source() const {
+            return source;
+        }
+
+        [[nodiscard]] const vector<uint32_t>& get_line_starts() const {
+            return line_starts;
+        }
+
+        /**
+         *
+         * @param token A token of this list
+         * @return The text of the token, multi-word keywords are spelled with single spaces
+         */
+        [[nodiscard]] std::string_view text(const Token& token) const;
+
+        /**
+         *
+         * @param token A token of this list
+         * @return 1-based column of the token, in code points
+         */
+        [[nodiscard]] int column(const Token& token) const;
+
+        /**
+         *
+         * @param line 1-based number of a line lexed already
+         * @return Text of the line without its line break
+         */
+        [[nodiscard]] std::string_view line(int line) const;
+
+        /**
+         * Column of a token counted from a code point before it on its line,
+         * for callers going through a long line from left to right
+         * @param token A token of this list
+         * @param from_offset Byte offset of a code point of the token's line, at or before the token
+         * @param from_column Column of that code point
+         * @return 1-based column of the token, in code points
+         */
+        [[nodiscard]] int column(const Token& token, uint32_t from_offset, int from_column) const;
     };
 }
 #endif //TOKEN_H
@@ -0,0 +1,77 @@
+#ifndef TRIE_H
+#define TRIE_H
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+namespace bao {
+    /**
+     * Keywords split into words, so the lexer only reads past a word
+     * when it can start a longer keyword
+     */
+    class KeywordTrie {
+        // Lets the children be looked up with a view into the source
+        struct WordHash {
+            using is_transparent = void;
+            size_t operator()(const std::string_view word) const {
+                return std::hash<std::string_view>{}(word);
+            }
+        };
+
+        struct Node {
+            uint32_t keyword = NONE; // Index of the keyword ending here
+            std::unordered_map<string, uint32_t, WordHash, std::equal_to<>> children;
+        };
+
+        vector<Node> nodes;
+    public:
+        static constexpr uint32_t ROOT = 0;
+        static constexpr uint32_t NONE = UINT32_MAX;
+
+        /**
+         *
+         * @param keywords Keywords, the words of which are separated by single spaces
+         */
+        explicit KeywordTrie(std::span<const std::string_view> keywords);
+
+        /**
+         *
+         * @return The trie of bao's keywords
+         */
+        static const KeywordTrie& global();
+
+        /**
+         *
+         * @param node Node reached so far
+         * @param word Next word
+         * @return The node after the word, NONE if no keyword continues with it
+         */
+        [[nodiscard]] uint32_t step(uint32_t node, std::string_view word) const;
+
+        /**
+         *
+         * @param node A node of the trie
+         * @return Index of the keyword the words up to the node form, NONE if they form none
+         */
+        [[nodiscard]] uint32_t keyword(const uint32_t node) const {
+            return nodes[node].keyword;
+        }
+
+        /**
+         *
+         * @param node A node of the trie
+         * @return Whether some longer keyword continues from the node
+         */
+        [[nodiscard]] bool has_children(const uint32_t node) const {
+            return !nodes[node].children.empty();
+        }
+    };
+}
+#endif //TRIE_H
@@ -0,0 +1,51 @@
+#ifndef UNICODE_H
+#define UNICODE_H
+#include <cstdint>
+#include <unicode/umachine.h>
+
+// Identifier and digit properties for the lexer. The tables are generated at
+// build time by tools/gen_unicode_tables.cpp so lookups never leave the binary.
+namespace bao::unicode {
+    enum Property : uint8_t {
+        XID_START = 1 << 0,
+        XID_CONTINUE = 1 << 1,
+        DIGIT = 1 << 2 // General category Nd
+    };
+
+    // Code points are split into blocks of 1 << BLOCK_SHIFT, identical blocks are stored once
+    constexpr int BLOCK_SHIFT = 7;
+    constexpr UChar32 BLOCK_SIZE = 1 << BLOCK_SHIFT;
+    constexpr UChar32 CODE_POINT_LIMIT = 0x110000;
+
+    namespace tables {
+        // Stage 1: block number of every block of code points
+        extern const uint16_t index[CODE_POINT_LIMIT >> BLOCK_SHIFT];
+        // Stage 2: property bits of every code point of the distinct blocks
+        extern const uint8_t blocks[];
+    }
+
+    /**
+     *
+     * @param cp Code point
+     * @return Property bits of the code point, 0 outside of Unicode
+     */
+    inline uint8_t properties(const UChar32 cp) {
+        if (static_cast<uint32_t>(cp) >= static_cast<uint32_t>(CODE_POINT_LIMIT)) {
+            return 0;
+        }
+        return tables::blocks[(tables::index[cp >> BLOCK_SHIFT] << BLOCK_SHIFT) | (cp & (BLOCK_SIZE - 1))];
+    }
+
+    inline bool is_xid_start(const UChar32 cp) {
+        return (properties(cp) & XID_START) != 0;
+    }
+
+    inline bool is_xid_continue(const UChar32 cp) {
+        return (properties(cp) & XID_CONTINUE) != 0;
+    }
+
+    inline bool is_digit(const UChar32 cp) {
+        return (properties(cp) & DIGIT) != 0;
+    }
+}
+#endif //UNICODE_H
@@ -4,7 +4,10 @@
 
 #ifndef MIR_H
 #define MIR_H
+#include <cstdint>
+#include <format>
 #include <string>
+#include <bao/interner.h>
 #include <bao/types.h>
 #include <sys/types.h>
 #include <vector>
@@ -18,18 +21,33 @@ namespace bao::mir {
 
     struct Value {
         ValueKind kind;
-        std::string name;
-        std::unique_ptr<Type> type;
+        std::string name; // Text of a constant
+        Symbol symbol = Interner::NONE; // Name of a variable
+        uint32_t index = 0; // Index of a temporary in its function
+        const Type* type;
+
+        Value(): kind(ValueKind::Constant), name(""), type(TypeContext::builtins().unknown()) {}
+        explicit Value(ValueKind&& kind, std::string&& name, const Type* type)
+            : kind(std::move(kind)), name(std::move(name)), type(type) {}
+        explicit Value(ValueKind&& kind, const Symbol symbol, const Type* type)
+            : kind(std::move(kind)), symbol(symbol), type(type) {}
+        // A temporary, function-local so it is only named when printed
+        explicit Value(const uint32_t index, const Type* type)
+            : kind(ValueKind::Temporary), index(index), type(type) {}
 
-        Value(const Value& copy) {
-            this->kind = copy.kind;
-            this->name = copy.name;
-            this->type = copy.type->clone();
+        /**
+         *
+         * @return Text of a constant, name of a variable or temporary
+         */
+        [[nodiscard]] std::string get_name() const {
+            if (kind == ValueKind::Temporary) {
+                return std::format("__temp{}", index);
+            }
+            if (symbol == Interner::NONE) {
+                return name;
+            }
+            return std::string(Interner::global().name(symbol));
         }
-        Value(Value&& rval) = default;
-        Value(): kind(ValueKind::Constant), name(""), type(std::move(std::make_unique<UnknownType>())) {}
-        explicit Value(ValueKind&& kind, std::string&& name, std::unique_ptr<Type>&& type)
-            : kind(std::move(kind)), name(std::move(name)), type(std::move(type)) {}
     };
 
     enum class BinaryOp {
@@ -51,11 +69,32 @@ namespace bao::mir {
         Lt_u,
     };
 
+    // Kind of every concrete instruction
+    enum class InstKind : uint8_t {
+        Alloc,
+        Store,
+        Load,
+        Call,
+        Bin,
+        Return,
+    };
+
     /**
      * Base class for all instructions
      */
     struct Instruction {
+        const InstKind kind;
+
+        explicit Instruction(const InstKind kind) : kind(kind) {}
         virtual ~Instruction() = default;
+
+        /**
+         *
+         * @return Kind of the instruction, for isa, cast and dyn_cast
+         */
+        [[nodiscard]] InstKind get_kind() const {
+            return kind;
+        }
     };
 
     /*
@@ -64,9 +103,10 @@ namespace bao::mir {
     * dst (type)
     */
     struct AllocInst final : Instruction {
+        static constexpr InstKind KIND = InstKind::Alloc;
         Value dst;
 
-        explicit AllocInst(Value& dst) : dst(dst) {}
+        explicit AllocInst(Value& dst) : Instruction(KIND), dst(dst) {}
     };
 
     /*
@@ -75,10 +115,11 @@ namespace bao::mir {
     * src -> dst
     */
     struct StoreInst final : Instruction {
+        static constexpr InstKind KIND = InstKind::Store;
         Value src;
         Value dst;
 
-        explicit StoreInst(Value&& src, Value& dst) : src(std::move(src)), dst(dst) {}
+        explicit StoreInst(Value&& src, Value& dst) : Instruction(KIND), src(std::move(src)), dst(dst) {}
     };
 
     /*
@@ -87,23 +128,26 @@ namespace bao::mir {
     * dst <- src
     */
     struct LoadInst final : Instruction {
+        static constexpr InstKind KIND = InstKind::Load;
         Value dst;
         Value src;
 
-        explicit LoadInst(Value& dst, Value&& src) : dst(dst), src(std::move(src)) {}
+        explicit LoadInst(Value& dst, Value&& src) : Instruction(KIND), dst(dst), src(std::move(src)) {}
     };
 
     struct CallInst final : Instruction {
+        static constexpr InstKind KIND = InstKind::Call;
         Value res;
         std::string function_name;
         std::vector<Value> arguments;
 
         explicit CallInst(Value&& res, std::string&& function_name, std::vector<Value>&& arguments)
-            : res(std::move(res)), function_name(std::move(function_name)), arguments(std::move(arguments)) {
+            : Instruction(KIND), res(std::move(res)), function_name(std::move(function_name)), arguments(std::move(arguments)) {
         }
     };
 
     struct BinInst final : Instruction {
+        static constexpr InstKind KIND = InstKind::Bin;
         Value dst;
         Value left;
         BinaryOp op;
@@ -114,20 +158,22 @@ namespace bao::mir {
             Value&& left, 
             BinaryOp&& op,
             Value&& right
-        ) : dst(dst),
+        ) : Instruction(KIND),
+            dst(dst),
             left(std::move(left)),
             op(std::move(op)),
             right(std::move(right)) {}
     };
 
     struct ReturnInst final : Instruction {
+        static constexpr InstKind KIND = InstKind::Return;
         Value ret_val;
 
         /**
          *
          * @param ret_val The return value
          */
-        explicit ReturnInst(Value&& ret_val) : ret_val(std::move(ret_val)) {
+        explicit ReturnInst(Value&& ret_val) : Instruction(KIND), ret_val(std::move(ret_val)) {
         }
     };
 
@@ -140,7 +186,7 @@ namespace bao::mir {
 
     struct Function {
         std::string name;
-        std::unique_ptr<Type> return_type;
+        const Type* return_type;
         std::vector<Value> parameters;
         std::vector<BasicBlock> blocks;
         int temp_var_count = 0;
@@ -17,7 +17,7 @@ namespace bao::mir {
     private:
         Function translate_function(const ast::FuncNode& func);
         void translate_statement(Function& func, ast::StmtNode* stmt);
-        Value translate_expression(Function& func, ast::StmtNode* stmt, ast::ExprNode* expr);
+        Value translate_expression(Function& func, ast::ExprNode* expr);
     };
 }
 #endif //TRANSLATOR_H
@@ -0,0 +1,59 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace bao::parallel {
+    /**
+     *
+     * @return How many threads the compiler should use for parallel work
+     */
+    inline unsigned worker_count() {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    /**
+     * Runs task(i) for every i in [0, count) on a pool of worker threads.
+     * Tasks are handed out in order, and the exception of the lowest
+     * failing index is rethrown once every task has finished
+     * @param count Number of tasks
+     * @param task Callable taking the task index
+     * @param threads Upper bound of threads to use, including the caller's
+     */
+    template<typename Task>
+    void for_each(const size_t count, Task&& task, const unsigned threads = worker_count()) {
+        if (count == 0) {
+            return;
+        }
+        std::vector<std::exception_ptr> exceptions(count);
+        std::atomic<size_t> next{0};
+        auto worker = [&] {
+            for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+                try {
+                    task(i);
+                } catch (...) {
+                    exceptions[i] = std::current_exception();
+                }
+            }
+        };
+        {
+            std::vector<std::jthread> pool;
+            const size_t extra = std::min<size_t>(std::max(1u, threads), count) - 1;
+            pool.reserve(extra);
+            for (size_t i = 0; i < extra; ++i) {
+                pool.emplace_back(worker);
+            }
+            worker(); // The calling thread works too
+        } // Joins the pool
+        for (const auto& exception : exceptions) {
+            if (exception) {
+                std::rethrow_exception(exception);
+            }
+        }
+    }
+}
+#endif //PARALLEL_H
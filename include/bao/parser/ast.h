@@ -4,10 +4,16 @@
 
 #ifndef AST_H
 #define AST_H
+#include <bao/arena.h>
+#include <bao/casting.h>
+#include <bao/interner.h>
 #include <bao/types.h>
 #include <bao/utils.h>
 #include <memory>
+#include <span>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -15,20 +21,63 @@ using std::string;
 using std::pair;
 using std::vector;
 
+// Nodes are allocated from the arena of their Program and point to each other
+// with plain pointers, the whole tree is released at once with the arena. No
+// node is destroyed through a base pointer, so none has a destructor to run
 namespace bao::ast {
+    // Binary operators, from the lowest precedence to the highest
+    enum class BinOp : uint8_t {
+        Or,
+        And,
+        Equal,
+        NotEqual,
+        LessEqual,
+        Less,
+        GreaterEqual,
+        Greater,
+        Add,
+        Sub,
+        Mul,
+        Div,
+    };
+
+    /**
+     *
+     * @param op A binary operator
+     * @return How it is spelled in the source
+     */
+    constexpr std::string_view bin_op_text(const BinOp op) {
+        constexpr std::string_view texts[] = {"hoặc", "và", "=", "!=", "<=", "<", ">=", ">", "+", "-", "*", "/"};
+        return texts[static_cast<size_t>(op)];
+    }
+
+    // Kind of every concrete node, stages switch on it instead of trying casts
+    enum class NodeKind : uint8_t {
+        Unknown,
+        Var,
+        Func,
+        // Statements
+        VarDeclStmt,
+        VarAssignStmt,
+        RetStmt,
+        // Expressions
+        NumLitExpr,
+        VarExpr,
+        BinExpr,
+    };
+
     // --- AST Node interface ---
     class ASTNode {
     protected:
-        string name;
+        NodeKind kind;
+        std::string_view name; // A literal or text in the arena
         int line;
         int column;
     public:
-        ASTNode(string name, const int line, const int column)
-            : name(std::move(name)), line(line), column(column) {
+        ASTNode(const NodeKind kind, const std::string_view name, const int line, const int column)
+            : kind(kind), name(name), line(line), column(column) {
         }
 
-        virtual ~ASTNode() = default;
-
         /**
          * Get the line and column of the node
          * @return Node's line and column in the source code
@@ -42,7 +91,15 @@ namespace bao::ast {
          * @return Node's name
          */
         [[nodiscard]] string get_name() const {
-            return name;
+            return string(name);
+        }
+
+        /**
+         *
+         * @return Kind of the node, for isa, cast and dyn_cast
+         */
+        [[nodiscard]] NodeKind get_kind() const {
+            return kind;
         }
     };
 
@@ -53,16 +110,15 @@ namespace bao::ast {
 
     class StmtNode : public ASTNode {
     public:
-        StmtNode(): ASTNode("unknown", 0, 0) {}
+        StmtNode(): ASTNode(NodeKind::Unknown, "unknown", 0, 0) {}
 
         StmtNode(
-            string name,
+            const NodeKind kind,
+            const std::string_view name,
             const int line,
             const int column
-        ):  ASTNode(std::move(name),
+        ):  ASTNode(kind, name,
             line, column) {}
-
-        ~StmtNode() override = default;
     };
 
     /**
@@ -70,56 +126,60 @@ namespace bao::ast {
      */
 
     class ExprNode : public ASTNode {
-        std::unique_ptr<Type> type;
+        const Type* type;
     public:
-        ExprNode(): ASTNode("unknown", 0, 0), type(std::move(std::make_unique<UnknownType>())) {}
         ExprNode(
-            string name,
-            std::unique_ptr<Type>&& type,
+            const NodeKind kind,
+            const std::string_view name,
+            const Type* type,
             const int line,
             const int column
-        ):  ASTNode(std::move(name),
-            line, column), type(std::move(type)) {}
-
-        ~ExprNode() override = default;
+        ):  ASTNode(kind, name,
+            line, column), type(type) {}
 
-        [[nodiscard]] Type* get_type() const {
-            return type.get();
+        [[nodiscard]] const Type* get_type() const {
+            return type;
         }
 
-        void set_type(std::unique_ptr<Type>&& new_type) {
-            type = std::move(new_type);
+        void set_type(const Type* new_type) {
+            type = new_type;
         }
     };
 
     // --- Program's variables ---
     class VarNode final : public ASTNode {
-        std::unique_ptr<Type> type;
+        Symbol symbol;
+        const Type* type;
         bool isConst;
     public:
-        VarNode(VarNode& cpy): ASTNode(cpy.name, cpy.line, cpy.column) {
-            this->type = cpy.type->clone();
-            this->isConst = cpy.isConst;
-        }
-        VarNode operator=(const VarNode& cpy) {
-            return VarNode(cpy.name, cpy.type->clone(), cpy.isConst, cpy.line, cpy.column);
-        }
+        static constexpr NodeKind KIND = NodeKind::Var;
+
         VarNode(
-            string name,
-            std::unique_ptr<Type>&& type,
+            const std::string_view name,
+            const Symbol symbol,
+            const Type* type,
             bool isConst,
             const int line,
             const int column
-        ):  ASTNode(name, line, column),
-            type(std::move(type)),
+        ):  ASTNode(KIND, name, line, column),
+            symbol(symbol),
+            type(type),
             isConst(isConst) {}
 
-        [[nodiscard]] Type* get_type() const {
-            return type.get();
+        /**
+         *
+         * @return Symbol of the variable's name
+         */
+        [[nodiscard]] Symbol get_symbol() const {
+            return symbol;
+        }
+
+        [[nodiscard]] const Type* get_type() const {
+            return type;
         }
 
-        void set_type(std::unique_ptr<Type>&& type) {
-            this->type = std::move(type);
+        void set_type(const Type* type) {
+            this->type = type;
         }
 
         [[nodiscard]] bool is_const() const {
@@ -128,94 +188,175 @@ namespace bao::ast {
     };
 
     // --- Program's function ---
+    /**
+     * Parses the bodies of functions that were skimmed over, see Parser::set_lazy_bodies
+     */
+    class BodySource {
+    public:
+        virtual ~BodySource() = default;
+
+        /**
+         * Parse a function body, can be called from several threads
+         * @param begin Index of the first token of the body
+         * @param end Index of the 'kết thúc' closing it
+         * @return Statements of the body, throws the errors met in it
+         */
+        [[nodiscard]] virtual std::span<StmtNode* const> parse_body(size_t begin, size_t end) const = 0;
+    };
+
     class FuncNode final : public ASTNode {
+        Symbol symbol;
         vector<VarNode> params;
-        vector<std::unique_ptr<StmtNode>> stmts;
-        std::unique_ptr<Type> return_type;
+        mutable std::span<StmtNode* const> stmts;
+        const Type* return_type;
+        // Parses the statements on first access, null once they are
+        mutable const BodySource* body = nullptr;
+        size_t body_begin = 0;
+        size_t body_end = 0;
     public:
+        static constexpr NodeKind KIND = NodeKind::Func;
+
         FuncNode(const FuncNode&) = delete;
         FuncNode& operator=(const FuncNode&) = delete;
         FuncNode(FuncNode&&) = default;
         FuncNode& operator=(FuncNode&&) = default;
 
         FuncNode(
-            string name,
+            const std::string_view name,
+            const Symbol symbol,
+            vector<VarNode>&& params,
+            const std::span<StmtNode* const> stmts,
+            const Type* return_type,
+            const int line, const int column
+        ):  ASTNode(KIND, name, line, column),
+            symbol(symbol),
+            params(std::move(params)),
+            stmts(stmts),
+            return_type(return_type) {
+        }
+
+        /**
+         * Function whose body is parsed on first access
+         * @param body Parser of the body, which has to outlive the node
+         * @param body_begin Index of the first token of the body
+         * @param body_end Index of the 'kết thúc' closing it
+         */
+        FuncNode(
+            const std::string_view name,
+            const Symbol symbol,
             vector<VarNode>&& params,
-            vector<std::unique_ptr<StmtNode>>&& stmts,
-            std::unique_ptr<Type>&& return_type,
+            const BodySource* body,
+            const size_t body_begin,
+            const size_t body_end,
+            const Type* return_type,
             const int line, const int column
-        ):  ASTNode(std::move(name), line, column),
+        ):  ASTNode(KIND, name, line, column),
+            symbol(symbol),
             params(std::move(params)),
-            stmts(std::move(stmts)),
-            return_type(std::move(return_type)) {
+            return_type(return_type),
+            body(body),
+            body_begin(body_begin),
+            body_end(body_end) {
+        }
+
+        /**
+         *
+         * @return Symbol of the function's name
+         */
+        [[nodiscard]] Symbol get_symbol() const {
+            return symbol;
         }
+
         [[nodiscard]] const vector<VarNode> &get_params() const {
             return params;
         }
 
-        [[nodiscard]] Type* get_return_type() const {
-            return return_type.get();
+        [[nodiscard]] const Type* get_return_type() const {
+            return return_type;
         }
 
-        [[nodiscard]] const vector<std::unique_ptr<StmtNode>> &get_stmts() const {
+        /**
+         * Parses the body first if it was skimmed over, not safe to call for
+         * the same function from several threads at once
+         * @return Statements of the body, throws the errors met in it
+         */
+        [[nodiscard]] std::span<StmtNode* const> get_stmts() const {
+            if (body) {
+                stmts = body->parse_body(body_begin, body_end);
+                body = nullptr;
+            }
             return stmts;
         }
+
+        /**
+         *
+         * @return Whether the statements are parsed already
+         */
+        [[nodiscard]] bool has_parsed_body() const {
+            return body == nullptr;
+        }
     };
 
     // --- Statements ---
 
     class VarDeclStmt final : public StmtNode {
         VarNode var;
-        std::unique_ptr<ExprNode> val;
+        ExprNode* val;
     public:
+        static constexpr NodeKind KIND = NodeKind::VarDeclStmt;
+
         explicit VarDeclStmt(
             VarNode var,
-            std::unique_ptr<ExprNode>&& val,
+            ExprNode* val,
             const int line, const int column
-        ) : StmtNode("vardeclstmt", line, column),
-            var(var), val(std::move(val)) {}
+        ) : StmtNode(KIND, "vardeclstmt", line, column),
+            var(var), val(val) {}
 
         [[nodiscard]] VarNode& get_var() {
             return this->var;
         }
 
         [[nodiscard]] ExprNode* get_val() const {
-            return val.get();
+            return val;
         }
     };
 
     class VarAssignStmt final : public StmtNode {
         VarNode var;
-        std::unique_ptr<ExprNode> val;
+        ExprNode* val;
     public:
+        static constexpr NodeKind KIND = NodeKind::VarAssignStmt;
+
         explicit VarAssignStmt(
             VarNode var,
-            std::unique_ptr<ExprNode>&& val,
+            ExprNode* val,
             const int line, const int column
-        ) : StmtNode("varassignstmt", line, column),
-            var(var), val(std::move(val)) {}
+        ) : StmtNode(KIND, "varassignstmt", line, column),
+            var(var), val(val) {}
 
         [[nodiscard]] VarNode& get_var() {
             return this->var;
         }
 
         [[nodiscard]] ExprNode* get_val() const {
-            return val.get();
+            return val;
         }
     };
 
     class RetStmt final : public StmtNode {
-        std::unique_ptr<ExprNode> val;
+        ExprNode* val;
     public:
+        static constexpr NodeKind KIND = NodeKind::RetStmt;
+
         explicit RetStmt(
-            std::unique_ptr<ExprNode> val,
+            ExprNode* val,
             const int line, const int column
             ):
-            StmtNode("retstmt", line, column),
-            val(std::move(val)) {}
+            StmtNode(KIND, "retstmt", line, column),
+            val(val) {}
 
         [[nodiscard]] ExprNode* get_val() const {
-            return val.get();
+            return val;
         }
     };
 
@@ -225,34 +366,45 @@ namespace bao::ast {
     * The simplest expression 
     */
     class NumLitExpr final : public ExprNode {
-        string value;
+        std::string_view value;
     public:
+        static constexpr NodeKind KIND = NodeKind::NumLitExpr;
+
         explicit NumLitExpr(
-            std::string value,
-            std::unique_ptr<Type> &&type,
+            const std::string_view value,
+            const Type* type,
             const int line,
             const int column
-        ):  ExprNode("numlitexpr", std::move(type), line, column),
-            value(std::move(value)) {}
+        ):  ExprNode(KIND, "numlitexpr", type, line, column),
+            value(value) {}
 
         [[nodiscard]] std::string get_val() const {
-            return value;
+            return string(value);
         }
     };
 
     class VarExpr final : public ExprNode {
-        std::string name;
+        std::string_view name;
+        Symbol symbol;
     public:
+        static constexpr NodeKind KIND = NodeKind::VarExpr;
+
         explicit VarExpr(
-            string name,
-            std::unique_ptr<Type>&& type,
+            const std::string_view name,
+            const Symbol symbol,
+            const Type* type,
             const int line,
             const int column
-        ):  ExprNode("varexpr", std::move(type), line, column),
-            name(std::move(name)) {}
+        ):  ExprNode(KIND, "varexpr", type, line, column),
+            name(name),
+            symbol(symbol) {}
 
         [[nodiscard]] std::string get_name() const {
-            return name;
+            return string(name);
+        }
+
+        [[nodiscard]] Symbol get_symbol() const {
+            return symbol;
         }
     };
 
@@ -260,47 +412,85 @@ namespace bao::ast {
     * Most important expression
     */
     class BinExpr final : public ExprNode {
-        std::unique_ptr<ExprNode> left;
-        std::string op;
-        std::unique_ptr<ExprNode> right;
+        ExprNode* left;
+        BinOp op;
+        ExprNode* right;
     public:
+        static constexpr NodeKind KIND = NodeKind::BinExpr;
+
         explicit BinExpr(
-            std::unique_ptr<ExprNode>&& left,
-            std::string&& op,
-            std::unique_ptr<ExprNode>&& right,
+            ExprNode* left,
+            const BinOp op,
+            ExprNode* right,
+            const Type* type,
             const int line,
             const int column
         ):
-        ExprNode("binexpr", std::make_unique<bao::UnknownType>(), line, column),
-        left(std::move(left)),
-        op(std::move(op)),
-        right(std::move(right)) {}
+        ExprNode(KIND, "binexpr", type, line, column),
+        left(left),
+        op(op),
+        right(right) {}
 
         [[nodiscard]] ExprNode* get_left() const {
-            return left.get();
+            return left;
         }
 
-        [[nodiscard]] std::string get_op() const {
+        [[nodiscard]] BinOp get_op() const {
             return op;
         }
 
         [[nodiscard]] ExprNode* get_right() const {
-            return right.get();
+            return right;
         }
     };
 
+    // The arena only frees its chunks, it never runs a node's destructor
+    static_assert(std::is_trivially_destructible_v<VarNode>);
+    static_assert(std::is_trivially_destructible_v<VarDeclStmt>);
+    static_assert(std::is_trivially_destructible_v<VarAssignStmt>);
+    static_assert(std::is_trivially_destructible_v<RetStmt>);
+    static_assert(std::is_trivially_destructible_v<NumLitExpr>);
+    static_assert(std::is_trivially_destructible_v<VarExpr>);
+    static_assert(std::is_trivially_destructible_v<BinExpr>);
+
     // --- Final parsed program ---
     struct Program {
+        Arena arena; // Every node of the program, released after the functions
+        std::unique_ptr<BodySource> bodies; // Parses the bodies skimmed over, null when there are none
         string name;
         string path;
         vector<FuncNode> funcs;
         explicit Program(
             string name, string path,
-            vector<FuncNode>&& funcs
+            vector<FuncNode>&& funcs,
+            Arena&& arena,
+            std::unique_ptr<BodySource>&& bodies = nullptr
         ):  
+        arena(std::move(arena)),
+        bodies(std::move(bodies)),
         name(std::move(name)),
         path(std::move(path)),
         funcs(std::move(funcs)) {}
+
+        /**
+         * Parse every body skimmed over, throws the errors met in them in source order
+         */
+        void force_bodies() const {
+            if (!bodies) {
+                return;
+            }
+            vector<std::exception_ptr> exceptions;
+            for (const FuncNode& func : funcs) {
+                try {
+                    static_cast<void>(func.get_stmts());
+                } catch (...) {
+                    exceptions.push_back(std::current_exception());
+                }
+            }
+            if (!exceptions.empty()) {
+                throw utils::ErrorList(exceptions);
+            }
+        }
     };
 }
 #endif //AST_H
@@ -0,0 +1,57 @@
+#ifndef CACHE_H
+#define CACHE_H
+#include <bao/parser/ast.h>
+#include <optional>
+#include <string>
+#include <string_view>
+
+using std::string;
+
+namespace bao {
+    /**
+     * Directory of parsed programs, one image per source file. An image is only
+     * used for the exact source and compiler build that wrote it, anything else
+     * reads as a miss and the caller parses the source as usual. A compiler
+     * built without a build ID (see tools/build_id.cmake) never reads or writes
+     * images
+     */
+    class AstCache {
+        string directory;
+    public:
+        /**
+         *
+         * @param directory Directory of the images, created on the first store
+         */
+        explicit AstCache(string directory);
+
+        /**
+         * Map the image of a source file. Function headers are read right away,
+         * the bodies are decoded on first access like skimmed bodies
+         * @param filename Name of the program
+         * @param directory Directory of the program
+         * @param source The source the program would be parsed from
+         * @param analyzed Whether the program has to have passed the analyzer
+         * @return The program, nothing if there is no usable image
+         */
+        [[nodiscard]] std::optional<ast::Program> load(const string& filename, const string& directory,
+                                                       std::string_view source, bool analyzed = false) const;
+
+        /**
+         * Write the image of a program, replacing the older one of its file.
+         * Parses every body skimmed over, throws the errors met in them
+         * @param program Program parsed from the source
+         * @param source The source
+         * @param analyzed Whether the program passed the analyzer
+         */
+        void store(const ast::Program& program, std::string_view source, bool analyzed = false) const;
+
+        /**
+         *
+         * @param filename Name of a program
+         * @param directory Directory of the program
+         * @return Path of the program's image
+         */
+        [[nodiscard]] string image_path(const string& filename, const string& directory) const;
+    };
+}
+#endif //CACHE_H
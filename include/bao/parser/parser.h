@@ -5,9 +5,12 @@
 #ifndef PARSER_H
 #define PARSER_H
 
+#include <array>
 #include <memory>
 #include <vector>
+#include <bao/lexer/lexer.h>
 #include <bao/lexer/token.h>
+#include <bao/parallel.h>
 #include <bao/parser/ast.h>
 #include <bao/utils.h>
 
@@ -15,49 +18,149 @@ using std::vector;
 
 namespace bao {
     class Parser {
+    public:
+        static constexpr size_t DEFAULT_MAX_NESTING = 256;
+
+    private:
         string filename;
         string directory;
-        vector<Token> tokens;
-        int it;
+        static constexpr size_t LOOKAHEAD = 4;
+
+        // Tokens come from the lexer as parsing goes, or from [position, end) of a list lexed ahead
+        Lexer* lexer = nullptr;
+        const TokenList* tokens = nullptr;
+        size_t position = 0;
+        size_t end = 0;
+        // Ring of the tokens pulled so far, the current one and the lookahead
+        std::array<Token, LOOKAHEAD> window{};
+        size_t head = 0; // Index of the current token
+        size_t pulled = 1; // Number of tokens pulled so far
+
+        Arena arena; // Nodes and names of the program, handed to it once parsed
+
+        size_t max_nesting = DEFAULT_MAX_NESTING; // Parentheses an expression can open
+        // Column of the token a column was last asked for, long lines are scanned from there
+        uint32_t column_line = 0;
+        uint32_t column_offset = 0;
+        int column_value = 1;
+
+        class LazyBodies;
+        std::unique_ptr<LazyBodies> bodies; // Parses skimmed bodies, handed to the program once parsed
+        const LazyBodies* lazy = nullptr; // Set when bodies are skimmed over
 
     public:
         /**
          *
          * @param filename Source file's name
          * @param directory Path to source file
-         * @param tokens Provide the tokens to parse
+         * @param lexer Lexer the tokens are pulled from as parsing goes
          */
         explicit Parser(
             const string &filename,
             const string &directory,
-            const vector<Token> &tokens
+            Lexer &lexer
         );
 
+        /**
+         *
+         * @param filename Source file's name
+         * @param directory Path to source file
+         * @param tokens Every token of the source, which have to outlive the parser
+         */
+        explicit Parser(
+            const string &filename,
+            const string &directory,
+            const TokenList &tokens
+        );
+
+        ~Parser();
+
+        /**
+         * Only parse the signatures of functions, their bodies are skimmed over
+         * and parsed on first access through FuncNode::get_stmts(). The tokens
+         * then have to outlive the program. A parser pulling from a Lexer
+         * always parses bodies
+         * @param enabled Whether to skim over bodies, off by default
+         */
+        void set_lazy_bodies(bool enabled);
+
+        /**
+         * Limit how deep parentheses nest in an expression, deeper ones are an error
+         * @param depth Most parentheses open at once, DEFAULT_MAX_NESTING by default
+         */
+        void set_max_nesting(size_t depth);
+
+        /**
+         * Parse the whole token stream, can only be called once
+         * @return The program, owning every node of it
+         */
         ast::Program parse_program();
+
+        /**
+         * Same program and errors as parse_program(), with the functions parsed
+         * concurrently. The tokens are skimmed for the lines starting with 'hàm' or
+         * 'thủ tục', and runs of whole functions are parsed on the workers. Parsing
+         * starts over sequentially when a part meets an error, so the errors are
+         * reported as parse_program() would. Needs the tokens of a whole source
+         * @param threads Upper bound of threads to use
+         * @return The program, owning every node of it
+         */
+        ast::Program parse_program_parallel(unsigned threads = parallel::worker_count());
     private:
+        /**
+         * Parser of the tokens of [begin, end), which ends in EndOfFile
+         */
+        Parser(const string &filename, const string &directory, const TokenList &tokens, size_t begin, size_t end);
+
+        /**
+         * Parse declarations up to the end of the tokens
+         * @param functions Where the functions parsed go
+         * @param exceptions Where the errors met go, parsing goes on after them
+         */
+        void parse_declarations(vector<ast::FuncNode>& functions, vector<exception_ptr>& exceptions);
+
+        /**
+         * Parse or skim over the body of a function whose signature was just parsed
+         * @return The function
+         */
+        ast::FuncNode parse_body(
+            std::string_view name,
+            Symbol symbol,
+            vector<ast::VarNode>&& params,
+            const Type* return_type,
+            int line, int column);
+        vector<ast::StmtNode*> parse_statements();
+
         // Highest priority
         ast::FuncNode parse_function();
         ast::FuncNode parse_procedure();
 
         // Parsing helpers
-        Token current();
+        const Token& current();
+        std::string_view current_value();
+        Symbol current_symbol();
+        int current_line();
+        int current_column();
+        [[nodiscard]] utils::CompilerError error(const string &message, int line, int column) const;
+        Token pull();
+        void seek(size_t index);
         void next();
-        Token peek();
+        const Token& peek();
         void skip_newlines();
         int current_precedence();
 
         ast::VarNode parse_var(bool isConst);
-        std::unique_ptr<Type> parse_type();
+        const Type* parse_type();
 
         // Statements
-        std::unique_ptr<ast::StmtNode> parse_statement();
-        std::unique_ptr<ast::RetStmt> parse_retstmt();
-        std::unique_ptr<ast::VarDeclStmt> parse_vardeclstmt(bool isConst);
-        std::unique_ptr<ast::VarAssignStmt> parse_varassignstmt();
+        ast::StmtNode* parse_statement();
+        ast::RetStmt* parse_retstmt();
+        ast::VarDeclStmt* parse_vardeclstmt(bool isConst);
+        ast::VarAssignStmt* parse_varassignstmt();
 
         // Expressions
-        std::unique_ptr<ast::ExprNode> parse_expression(int minPrec);
-        std::unique_ptr<ast::ExprNode> parse_primary();
+        ast::ExprNode* parse_expression(int minPrec);
+        ast::ExprNode* parse_primary();
     };
 }
 #endif //PARSER_H
@@ -0,0 +1,161 @@
+#ifndef PHF_H
+#define PHF_H
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+// Perfect hash tables built at compile time for the fixed vocabularies of the
+// compiler. They are immutable, never allocate and can be shared by any thread.
+namespace bao::phf {
+    /**
+     * FNV-1a over the UTF-8 bytes, perturbed by a seed
+     */
+    constexpr uint64_t hash(const std::string_view key, const uint64_t seed) {
+        uint64_t h = 0xCBF29CE484222325ULL ^ (seed * 0x9E3779B97F4A7C15ULL);
+        for (const char c : key) {
+            h ^= static_cast<uint8_t>(c);
+            h *= 0x100000001B3ULL;
+        }
+        // Multiplication only carries upwards, fold the high bits into the slot bits
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDULL;
+        return h ^ (h >> 33);
+    }
+
+    /**
+     * Map from a fixed set of strings to values, every key has a slot of its own
+     */
+    template<typename Value, size_t N>
+    class Map {
+    public:
+        using Entry = std::pair<std::string_view, Value>;
+        static constexpr size_t SLOTS = std::bit_ceil(N * 2);
+        static_assert(N < 256, "Bảng băm hoàn hảo quá lớn");
+
+    private:
+        std::array<Entry, N> entries{};
+        std::array<std::string_view, N> key_list{};
+        std::array<uint8_t, SLOTS> slots{}; // Entry index + 1, 0 when empty
+        uint64_t seed = 0;
+
+        [[nodiscard]] constexpr size_t slot(const std::string_view key) const {
+            return hash(key, this->seed) & (SLOTS - 1);
+        }
+
+        consteval void build() {
+            for (size_t i = 0; i < N; i++) {
+                this->key_list[i] = this->entries[i].first;
+            }
+            // Try seeds until no two keys share a slot
+            for (;; this->seed++) {
+                this->slots = {};
+                bool collided = false;
+                for (size_t i = 0; i < N && !collided; i++) {
+                    uint8_t& target = this->slots[this->slot(this->entries[i].first)];
+                    collided = target != 0;
+                    target = static_cast<uint8_t>(i + 1);
+                }
+                if (!collided) {
+                    break;
+                }
+            }
+        }
+
+    public:
+        consteval explicit Map(const Entry (&list)[N]) {
+            for (size_t i = 0; i < N; i++) {
+                this->entries[i] = list[i];
+            }
+            this->build();
+        }
+
+        consteval explicit Map(const std::array<Entry, N>& list) : entries(list) {
+            this->build();
+        }
+
+        /**
+         *
+         * @param key Key to look up
+         * @return Pointer to the value, nullptr if the key is not in the map
+         */
+        [[nodiscard]] constexpr const Value* find(const std::string_view key) const {
+            const uint8_t index = this->slots[this->slot(key)];
+            if (index == 0 || this->entries[index - 1].first != key) {
+                return nullptr;
+            }
+            return &this->entries[index - 1].second;
+        }
+
+        [[nodiscard]] constexpr bool contains(const std::string_view key) const {
+            return this->find(key) != nullptr;
+        }
+
+        [[nodiscard]] constexpr const Value& at(const std::string_view key) const {
+            if (const Value* value = this->find(key)) {
+                return *value;
+            }
+            throw std::out_of_range("Lỗi nội bộ: khoá không có trong bảng");
+        }
+
+        /**
+         *
+         * @return Every key, in the order they were given
+         */
+        [[nodiscard]] constexpr std::span<const std::string_view> keys() const {
+            return this->key_list;
+        }
+
+        [[nodiscard]] constexpr auto begin() const {
+            return this->entries.begin();
+        }
+
+        [[nodiscard]] constexpr auto end() const {
+            return this->entries.end();
+        }
+    };
+
+    /**
+     * Set of fixed strings
+     */
+    template<size_t N>
+    class Set {
+        Map<bool, N> map;
+
+        static consteval std::array<std::pair<std::string_view, bool>, N> entries(const std::string_view (&keys)[N]) {
+            std::array<std::pair<std::string_view, bool>, N> list{};
+            for (size_t i = 0; i < N; i++) {
+                list[i] = {keys[i], true};
+            }
+            return list;
+        }
+
+    public:
+        consteval explicit Set(const std::string_view (&keys)[N]) : map(entries(keys)) {}
+
+        [[nodiscard]] constexpr bool contains(const std::string_view key) const {
+            return this->map.contains(key);
+        }
+
+        /**
+         *
+         * @return Every key, in the order they were given
+         */
+        [[nodiscard]] constexpr std::span<const std::string_view> keys() const {
+            return this->map.keys();
+        }
+    };
+
+    /**
+     * Builds a Map, deducing its size from the entries
+     */
+    template<typename Value, size_t N>
+    consteval Map<Value, N> make_map(const std::pair<std::string_view, Value> (&list)[N]) {
+        return Map<Value, N>(list);
+    }
+}
+#endif //PHF_H
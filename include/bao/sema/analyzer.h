@@ -6,6 +6,7 @@
 #define ANALYZER_H
 #include <bao/sema/symtabl.h>
 #include <bao/parser/ast.h>
+#include <bao/parallel.h>
 
 namespace bao {
     class Analyzer {
@@ -14,20 +15,32 @@ namespace bao {
     public:
         explicit Analyzer(ast::Program&& program);
         ast::Program analyze_program();
+
+        /**
+         * Same program and errors as analyze_program(), with the functions analyzed
+         * concurrently once every function is declared. Each worker resolves names in
+         * its own copy of the global scope, which no function changes. Small programs
+         * are analyzed sequentially
+         * @param threads Upper bound of threads to use
+         * @return The analyzed program
+         */
+        ast::Program analyze_program_parallel(unsigned threads = parallel::worker_count());
     private:
-        void analyze_function(const ast::FuncNode& func);
+        void analyze_function(sema::SymbolTable& table, const ast::FuncNode& func);
 
         // Statements
-        void analyze_statement(sema::SymbolTable& parentTable, ast::StmtNode* stmt, Type* return_type);
-        void analyze_retstmt(sema::SymbolTable& parentTable, ast::RetStmt* stmt, Type* return_type);
+        void analyze_statement(sema::SymbolTable& parentTable, ast::StmtNode* stmt, const Type* return_type);
+        void analyze_retstmt(sema::SymbolTable& parentTable, ast::RetStmt* stmt, const Type* return_type);
         void analyze_vardeclstmt(sema::SymbolTable& parentTable, ast::VarDeclStmt* stmt);
         void analyze_varassignstmt(sema::SymbolTable& parentTable, ast::VarAssignStmt* stmt);
 
         // Expressions
         void analyze_expression(sema::SymbolTable& parentTable, ast::ExprNode* expr);
+        void analyze_operand(sema::SymbolTable& parentTable, ast::ExprNode* expr);
+        void analyze_binary(ast::BinExpr* expr, bool left_literal, bool right_literal);
 
         // Helpers
-        void analyze_type(ast::ExprNode* val, Type* type);
+        void analyze_type(ast::ExprNode* val, const Type* type);
     };
 }
 #endif //ANALYZER_H
@@ -4,8 +4,10 @@
 
 #ifndef SYMTABL_H
 #define SYMTABL_H
+#include <cstdint>
 #include <iostream>
-#include <unordered_map>
+#include <vector>
+#include <bao/interner.h>
 #include <bao/types.h>
 
 namespace bao::sema {
@@ -17,41 +19,135 @@ namespace bao::sema {
 
     struct SymbolInfo {
         SymbolType type;
-        Type* datatype;
+        const Type* datatype;
         bool isConst;
     };
 
+    /**
+     * Every scope in one table. A name maps to its innermost declaration, which
+     * chains to the one it shadows. Leaving a scope pops the declarations made
+     * in it, so scopes cost what they declare and a lookup is one probe
+     */
     class SymbolTable {
-        std::unordered_map<std::string, SymbolInfo> table;
-        SymbolTable* parent;
+        static constexpr uint32_t NONE = UINT32_MAX;
+
+        struct Entry {
+            Symbol name;
+            SymbolInfo info;
+            uint32_t scope; // Depth of the scope declaring it
+            uint32_t shadowed; // Entry of the same name it hides, NONE if there is none
+        };
+
+        // Open addressing over the name, a slot stays with its name once taken
+        struct Slot {
+            Symbol name = Interner::NONE;
+            uint32_t entry = NONE; // Innermost declaration, NONE when no scope declares the name
+        };
+
+        std::vector<Entry> entries; // Declarations of the open scopes, innermost last
+        std::vector<uint32_t> scopes; // Size of entries when each open scope was entered
+        std::vector<Slot> slots;
+        size_t used = 0; // Slots taken
+
+        [[nodiscard]] size_t probe(const Symbol name) const {
+            const size_t mask = slots.size() - 1;
+            // Symbols are dense per interner shard, spread them over the table
+            size_t index = (static_cast<uint32_t>(name) * 0x9E3779B1u) & mask;
+            while (slots[index].name != name && slots[index].name != Interner::NONE) {
+                index = (index + 1) & mask;
+            }
+            return index;
+        }
+
+        void grow() {
+            std::vector<Slot> old = std::move(slots);
+            slots.assign(old.empty() ? 64 : old.size() * 2, Slot{});
+            for (const Slot& slot : old) {
+                if (slot.name != Interner::NONE) {
+                    slots[this->probe(slot.name)] = slot;
+                }
+            }
+        }
+
     public:
-        SymbolTable(): parent(nullptr) {}
-        SymbolTable(SymbolTable* parent): parent(parent) {}
+        /**
+         * Scope entered for as long as the guard lives
+         */
+        class Scope {
+            SymbolTable& table;
+        public:
+            explicit Scope(SymbolTable& table) : table(table) {
+                table.enter_scope();
+            }
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+            ~Scope() {
+                table.leave_scope();
+            }
+        };
 
-        bool insert(const std::string& name, const SymbolInfo& info) {
-            return table.emplace(name, info).second;
+        SymbolTable() = default;
+
+        void enter_scope() {
+            scopes.push_back(static_cast<uint32_t>(entries.size()));
         }
 
-        SymbolInfo* lookup(const std::string& name) {
-            const auto it = table.find(name);
-            if (it != table.end()) {
-                return &it->second;
+        /**
+         * Forget the declarations of the innermost scope, the ones they shadowed are visible again
+         */
+        void leave_scope() {
+            const uint32_t marker = scopes.back();
+            scopes.pop_back();
+            while (entries.size() > marker) {
+                const Entry& entry = entries.back();
+                slots[this->probe(entry.name)].entry = entry.shadowed;
+                entries.pop_back();
             }
-            if (parent) {
-                return parent->lookup(name);
+        }
+
+        /**
+         *
+         * @param name Name to declare in the innermost scope
+         * @param info What the name stands for
+         * @return Whether it was declared, false if the innermost scope declares it already
+         */
+        bool insert(const Symbol name, const SymbolInfo& info) {
+            if ((used + 1) * 4 > slots.size() * 3) {
+                this->grow();
+            }
+            Slot& slot = slots[this->probe(name)];
+            const auto depth = static_cast<uint32_t>(scopes.size());
+            if (slot.entry != NONE && entries[slot.entry].scope == depth) {
+                return false;
             }
-            return nullptr;
+            if (slot.name == Interner::NONE) {
+                slot.name = name;
+                used++;
+            }
+            entries.push_back({name, info, depth, slot.entry});
+            slot.entry = static_cast<uint32_t>(entries.size() - 1);
+            return true;
         }
 
-        bool remove(const std::string& name) {
-            return table.erase(name) > 0;
+        /**
+         *
+         * @param name Name to resolve
+         * @return Its innermost declaration, null if no open scope declares it. Valid until the next insert
+         */
+        [[nodiscard]] const SymbolInfo* lookup(const Symbol name) const {
+            if (slots.empty()) {
+                return nullptr;
+            }
+            const Slot& slot = slots[this->probe(name)];
+            return slot.entry == NONE ? nullptr : &entries[slot.entry].info;
         }
 
         void dump() const {
-            for (const auto& [name, info] : table) {
-                std::cout << "Name: " << name
-                        << ", Type: " << static_cast<int>(info.type)
-                        << ", DataType: " << info.datatype->get_name();
+            for (const Entry& entry : entries) {
+                std::cout << "Name: " << Interner::global().name(entry.name)
+                        << ", Type: " << static_cast<int>(entry.info.type)
+                        << ", DataType: " << entry.info.datatype->get_name()
+                        << ", Scope: " << entry.scope << std::endl;
             }
         }
     };
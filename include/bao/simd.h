@@ -0,0 +1,52 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+// SSE2 is part of every x86-64 CPU, AVX2 has to be checked at runtime
+#if defined(__x86_64__) || defined(_M_X64)
+    #define BAO_SIMD_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        #define BAO_TARGET_AVX2
+    #else
+        #define BAO_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#else
+    #define BAO_SIMD_X86 0
+    #define BAO_TARGET_AVX2
+#endif
+
+namespace bao::simd {
+    /**
+     *
+     * @return Whether the running CPU (and OS) supports AVX2, checked once
+     */
+    inline bool has_avx2() {
+#if BAO_SIMD_X86
+    #if defined(_MSC_VER) && !defined(__clang__)
+        static const bool supported = [] {
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7) {
+                return false;
+            }
+            __cpuid(info, 1);
+            const bool osxsave = (info[2] & (1 << 27)) != 0;
+            const bool avx = (info[2] & (1 << 28)) != 0;
+            // The OS has to save the YMM registers too
+            if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+                return false;
+            }
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+        }();
+    #else
+        static const bool supported = __builtin_cpu_supports("avx2");
+    #endif
+        return supported;
+#else
+        return false;
+#endif
+    }
+}
+#endif //SIMD_H
@@ -5,24 +5,40 @@
 #ifndef TYPES_H
 #define TYPES_H
 
+#include <array>
+#include <cstdint>
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <utility>
 
-#include "lexer/maps.h"
+#include <bao/phf.h>
 
 using std::string;
 
 namespace bao {
+    // Kind of every concrete type
+    enum class TypeKind : uint8_t {
+        Primitive,
+        Unknown,
+    };
+
+    class TypeContext;
+
     // --- Type base class ---
+    // Types are owned by a TypeContext and never copied, equal types are the same object
     class Type {
+        TypeKind kind;
         string name;
+    protected:
+        explicit Type(const TypeKind kind, string name) : kind(kind), name(std::move(name)) {}
     public:
-        explicit Type(string name) : name(std::move(name)) {}
+        Type(const Type&) = delete;
+        Type& operator=(const Type&) = delete;
         virtual ~Type() = default;
-        [[nodiscard]] string get_name() const { return name; }
-        virtual std::unique_ptr<Type> clone() const = 0;
+        [[nodiscard]] const string& get_name() const { return name; }
+        [[nodiscard]] TypeKind get_kind() const { return kind; }
     };
 
     enum class Primitive {
@@ -36,23 +52,80 @@ namespace bao {
         Null, // Null type
     };
 
+    constexpr auto primitive_map = phf::make_map<Primitive>({
+        {"N32", Primitive::N32},
+        {"N64", Primitive::N64},
+        {"Z32", Primitive::Z32},
+        {"Z64", Primitive::Z64},
+        {"R32", Primitive::R32},
+        {"R64", Primitive::R64},
+        {"rỗng", Primitive::Void},
+        {"null", Primitive::Null}
+    });
+
     // --- Primitive type ---
     class PrimitiveType final : public Type {
         Primitive type;
+        friend class TypeContext;
+
+        explicit PrimitiveType(const std::string_view name, const Primitive type) : Type(KIND, string(name)), type(type) {}
     public:
-        explicit PrimitiveType(const string &type) : Type(type), type(primitive_map.at(type)) {}
+        static constexpr TypeKind KIND = TypeKind::Primitive;
+
         [[nodiscard]] Primitive get_type() const { return type; }
-        std::unique_ptr<Type> clone() const {
-            return std::make_unique<PrimitiveType>(*this);
-        }
     };
 
     class UnknownType final : public Type {
+        friend class TypeContext;
+
+        explicit UnknownType() : Type(KIND, "unknown") {}
+    public:
+        static constexpr TypeKind KIND = TypeKind::Unknown;
+    };
+
+    /**
+     * Owns one object of every builtin type, so types compare by address and
+     * no stage allocates to describe one. There is only the one context of
+     * builtins, built before first use and never changed afterwards, which is
+     * what makes sharing it between compilations and threads safe. Types a
+     * program declares must not go here, they belong to a context owned by
+     * their compilation
+     */
+    class TypeContext {
+        std::array<std::unique_ptr<PrimitiveType>, primitive_map.keys().size()> primitives; // Indexed by Primitive
+        std::unique_ptr<UnknownType> unknown_type;
+
+        TypeContext();
     public:
-        explicit UnknownType() : Type("unknown") {}
-        std::unique_ptr<Type> clone() const {
-            return std::make_unique<UnknownType>(*this);
-            // throw std::runtime_error("Không thể clone kiểu Unknown");
+        TypeContext(const TypeContext&) = delete;
+        TypeContext& operator=(const TypeContext&) = delete;
+
+        /**
+         *
+         * @return The builtin types, read-only
+         */
+        static const TypeContext& builtins();
+
+        [[nodiscard]] const PrimitiveType* primitive(const Primitive primitive) const {
+            return primitives[static_cast<size_t>(primitive)].get();
+        }
+
+        /**
+         *
+         * @param name Name of a primitive type
+         * @return The type, null if no primitive has that name
+         */
+        [[nodiscard]] const PrimitiveType* primitive(const std::string_view name) const {
+            const Primitive* primitive = primitive_map.find(name);
+            return primitive ? this->primitive(*primitive) : nullptr;
+        }
+
+        /**
+         *
+         * @return Type of the nodes not resolved yet
+         */
+        [[nodiscard]] const UnknownType* unknown() const {
+            return unknown_type.get();
         }
     };
 }
@@ -10,10 +10,9 @@
 #include <bao/lexer/token.h>
 #include <utility>
 #include <vector>
-#include <bao/filereader/reader.h>
+#include <bao/filereader/manager.h>
 #include <filesystem>
 #include <unordered_map>
-#include <functional>
 #include <format>
 #include <sstream>
 #include <llvm/IR/IRBuilder.h>
@@ -61,6 +60,15 @@ namespace bao::utils {
      */
     bool arg_contains(int argc, char *argv[], const char *target);
 
+    /**
+     * Helper function to read the value following a program argument
+     * @param argc Program argument count
+     * @param argv Program argument variables
+     * @param target C_string target argument
+     * @return The argument after it, null if it is missing or last
+     */
+    const char* arg_value(int argc, char *argv[], const char *target);
+
     /**
      * Helper function to print how to use the compiler
      */
@@ -68,9 +76,10 @@ namespace bao::utils {
 
     /**
      * Helper function to print tokens
-     * @param token The tokens from the lexer
+     * @param tokens The tokens from the lexer
+     * @param token The token to print
      */
-    void print_token(const Token &token);
+    void print_token(const TokenList &tokens, const Token &token);
 
     void trim(std::string& str);
 
@@ -100,17 +109,6 @@ namespace bao::utils {
         void print_value(const bao::mir::Value& value, const string &padding);
     }
 
-    /**
-     * Helper function for matching a value against a set of patterns
-     * @param val Value to match
-     * @param pattern Pattern to match against
-     * @param default_case In case of no match, this function will be called
-     */
-    void match(
-        const string &val,
-        const std::unordered_map<string, std::function<void()> > &pattern,
-        const std::function<void()> &default_case);
-
     // --- Error list class ---
     /**
      * Helper class for making a list of errors
@@ -161,13 +159,18 @@ namespace bao::utils {
             const int length = 0
         ): line(line),
            column(column) {
-            const Reader reader(std::move(filepath));
-            string content = reader.get_line(line);
-            string liner(std::ranges::max(column - 1, 0), '~');
-            if (length > 0) {
-                liner += std::string(length, '^');
-            }
-            this->message = std::format("{}\n\033[32m{}^\033[0m\n[Dòng {}, Cột {}] {}", content, liner, line, column, message);
+            this->describe(SourceManager::global().get_line(filepath, line), message, length);
+        }
+
+        explicit CompilerError(
+            const string &message,
+            const TokenList &tokens,
+            const int line,
+            const int column,
+            const int length = 0
+        ): line(line),
+           column(column) {
+            this->describe(tokens.line(line), message, length);
         }
 
         [[nodiscard]] const char* what() const noexcept override {
@@ -190,6 +193,28 @@ namespace bao::utils {
             const fs::path fullpath = directory / filename;
             return CompilerError(std::move(message), fullpath.string(), line, column, length);
         }
+
+        /**
+         *  Helper function for creating new compiler errors, quoting the source that was lexed
+         * @param tokens Tokens of the source to preview
+         * @param message Error message
+         * @param line Line of source file
+         * @param column Column of source file
+         * @return A CompilerError object to throw
+         */
+        static CompilerError new_error(const TokenList &tokens, const string &message, const int line,
+                                       const int column, const int length = 0) {
+            return CompilerError(message, tokens, line, column, length);
+        }
+
+    private:
+        void describe(const std::string_view content, const string &message, const int length) {
+            string liner(std::ranges::max(this->column - 1, 0), '~');
+            if (length > 0) {
+                liner += std::string(length, '^');
+            }
+            this->message = std::format("{}\n\033[32m{}^\033[0m\n[Dòng {}, Cột {}] {}", content, liner, this->line, this->column, message);
+        }
     };
 
     /**
@@ -217,19 +242,17 @@ namespace bao::utils {
 
     bool is_literal(bao::ast::ExprNode* expr);
     bool can_cast_literal(const bao::ast::ExprNode* expr, const Type* type);
-    void cast_literal(bao::ast::ExprNode* expr, Type* type);
-
-    llvm::Type* get_llvm_type(llvm::IRBuilder<>& builder, bao::Type* type);
+    void cast_literal(bao::ast::ExprNode* expr, const Type* type);
 
-    std::string type_to_string(Type* type);
+    llvm::Type* get_llvm_type(llvm::IRBuilder<>& builder, const bao::Type* type);
 
-    std::unique_ptr<Type> clone_type(Type* type);
+    std::string type_to_string(const Type* type);
 
     int generate_start();
 
-    bool is_signed(Type* type);
+    bool is_signed(const Type* type);
 
-    bool is_float(Type* type);
+    bool is_float(const Type* type);
 }
 
 #endif //UTILS_H
@@ -6,7 +6,7 @@
 int main(const int argc, char *argv[]) {
 
     if (argc < 2) {
-        throw std::invalid_argument("Cú pháp: baoc [--test] [--huong-dan]");
+        throw std::invalid_argument("Cú pháp: baoc [--test] [--bo-nho-dem <thư mục>] [--huong-dan]");
     }
     if (bao::utils::arg_contains(argc, argv, "--huong-dan")) {
         bao::utils::print_usage();
@@ -92,13 +92,14 @@ bao::Generator :: generate_function(
     mir::Function& mir_func
 ) {
     this->current_context = {};
+    this->current_temporaries.assign(mir_func.temp_var_count, nullptr);
     try {
         // Get function type - Can be thrown an error
         llvm::FunctionType *funcType = 
             llvm::FunctionType::get(
                 utils::get_llvm_type(
                     this->ir_builder, 
-                    mir_func.return_type.get()), 
+                    mir_func.return_type), 
                 false);
         
         // Creating the function
@@ -161,237 +162,245 @@ bao::Generator :: generate_instruction(
     bao::mir::Instruction* mir_inst
 ) {
     try {
-        // Return instruction
-        if (auto retInst = dynamic_cast<mir::ReturnInst*>(mir_inst)) {
-            auto val = get_llvm_value(retInst->ret_val);
-            if (val) {
-                this->ir_builder.CreateRet(val);
-            } else {
-                this->ir_builder.CreateRetVoid();
-            }
-            return;
-        }
-
-        // Stack allocation instruction
-        if (auto allocInst = dynamic_cast<mir::AllocInst*>(mir_inst)) {
-            auto alloca = this->ir_builder.CreateAlloca(
-                utils::get_llvm_type(
-                    this->ir_builder, 
-                    allocInst->dst.type.get()
-                )
-            );
-            alloca->setName(allocInst->dst.name);
-            current_context[allocInst->dst.name] = alloca;
-            return;
-        }
-
-        // Store to a pointer
-        if (auto storeInst = dynamic_cast<mir::StoreInst*>(mir_inst)) {
-            auto src = this->get_llvm_value(storeInst->src);
-            auto dst = this->get_llvm_value(storeInst->dst);
-            // TODO: Handle volatility
-            this->ir_builder.CreateStore(src, dst, false);
-            return;
-        }
-
-        // Load from an alloca
-        if (auto loadInst = dynamic_cast<mir::LoadInst*>(mir_inst)) {
-            auto src = this->get_llvm_value(loadInst->src);
-
-            auto load = this->ir_builder.CreateLoad(
-                utils::get_llvm_type(
-                    this->ir_builder,
-                    loadInst->dst.type.get()
-                ),
-                src
-            );
-            load->setName(loadInst->dst.name);
-            current_context[loadInst->dst.name] = load;
-            return;
-        }
-
-        // Arithmatic instructions
-        if (auto binInst = dynamic_cast<mir::BinInst*>(mir_inst)) {
-            auto left = get_llvm_value(binInst->left);
-            auto right = get_llvm_value(binInst->right);
-            llvm::Value* dst = nullptr;
-            switch (binInst->op) {
-            case mir::BinaryOp::Add_f: {
-                dst = this->ir_builder.CreateFAdd(left, right, binInst->dst.name);
-            }
-            break;
-            case mir::BinaryOp::Add_s: {
-                llvm::Function *saddFunc = llvm::Intrinsic::getOrInsertDeclaration(
-                    &this->llvm_module, 
-                    llvm::Intrinsic::sadd_with_overflow,
-                    {bao::utils::get_llvm_type(
-                        this->ir_builder,
-                        binInst->dst.type.get()
-                    )}
-                );
-
-                llvm::Value *resStruct = this->ir_builder.CreateCall(
-                    saddFunc, {left, right}
-                );
-
-                dst = this->ir_builder.CreateExtractValue(
-                    resStruct, 0
-                );
-
-                // Not really doing anything for now
-                llvm::Value *overflow = this->ir_builder.CreateExtractValue(
-                    resStruct, 1
-                );
+        switch (mir_inst->get_kind()) {
+            // Return instruction
+            case mir::InstKind::Return: {
+                auto retInst = cast<mir::ReturnInst>(mir_inst);
+                auto val = get_llvm_value(retInst->ret_val);
+                if (val) {
+                    this->ir_builder.CreateRet(val);
+                } else {
+                    this->ir_builder.CreateRetVoid();
+                }
+                return;
             }
-            break;
-            case mir::BinaryOp::Add_u: {
-                llvm::Function *uaddFunc = llvm::Intrinsic::getOrInsertDeclaration(
-                    &this->llvm_module, 
-                    llvm::Intrinsic::uadd_with_overflow,
-                    {bao::utils::get_llvm_type(
-                        this->ir_builder,
-                        binInst->dst.type.get()
-                    )}
-                );
 
-                llvm::Value *resStruct = this->ir_builder.CreateCall(
-                    uaddFunc, {left, right}
+            // Stack allocation instruction
+            case mir::InstKind::Alloc: {
+                auto allocInst = cast<mir::AllocInst>(mir_inst);
+                auto alloca = this->ir_builder.CreateAlloca(
+                    utils::get_llvm_type(
+                        this->ir_builder, 
+                        allocInst->dst.type
+                    )
                 );
-
-                dst = this->ir_builder.CreateExtractValue(
-                    resStruct, 0
-                );
-
-                llvm::Value *overflow = this->ir_builder.CreateExtractValue(
-                    resStruct, 1
-                );
-            }
-            break;
-            case mir::BinaryOp::Sub_f: {
-                dst = this->ir_builder.CreateFSub(left, right, binInst->dst.name);
+                alloca->setName(allocInst->dst.get_name());
+                current_context[allocInst->dst.symbol] = alloca;
+                return;
             }
-            break;
-            case mir::BinaryOp::Sub_s: {
-                llvm::Function *ssubFunc = llvm::Intrinsic::getOrInsertDeclaration(
-                    &this->llvm_module, 
-                    llvm::Intrinsic::ssub_with_overflow,
-                    {bao::utils::get_llvm_type(
-                        this->ir_builder,
-                        binInst->dst.type.get()
-                    )}
-                );
 
-                llvm::Value *resStruct = this->ir_builder.CreateCall(
-                    ssubFunc, {left, right}
-                );
-
-                dst = this->ir_builder.CreateExtractValue(
-                    resStruct, 0
-                );
-
-                llvm::Value *overflow = this->ir_builder.CreateExtractValue(
-                    resStruct, 1
-                );
+            // Store to a pointer
+            case mir::InstKind::Store: {
+                auto storeInst = cast<mir::StoreInst>(mir_inst);
+                auto src = this->get_llvm_value(storeInst->src);
+                auto dst = this->get_llvm_value(storeInst->dst);
+                // TODO: Handle volatility
+                this->ir_builder.CreateStore(src, dst, false);
+                return;
             }
-            break;
-            case mir::BinaryOp::Sub_u: {
-                llvm::Function *usubFunc = llvm::Intrinsic::getOrInsertDeclaration(
-                    &this->llvm_module, 
-                    llvm::Intrinsic::usub_with_overflow,
-                    {bao::utils::get_llvm_type(
-                        this->ir_builder,
-                        binInst->dst.type.get()
-                    )}
-                );
 
-                llvm::Value *resStruct = this->ir_builder.CreateCall(
-                    usubFunc, {left, right}
-                );
+            // Load from an alloca
+            case mir::InstKind::Load: {
+                auto loadInst = cast<mir::LoadInst>(mir_inst);
+                auto src = this->get_llvm_value(loadInst->src);
 
-                dst = this->ir_builder.CreateExtractValue(
-                    resStruct, 0
-                );
-
-                llvm::Value *overflow = this->ir_builder.CreateExtractValue(
-                    resStruct, 1
-                );
-            }
-            break;
-            case mir::BinaryOp::Mul_f: {
-                dst = this->ir_builder.CreateFMul(left, right, binInst->dst.name);
-            }
-            break;
-            case mir::BinaryOp::Mul_s: {
-                llvm::Function *smulFunc = llvm::Intrinsic::getOrInsertDeclaration(
-                    &this->llvm_module, 
-                    llvm::Intrinsic::smul_with_overflow,
-                    {bao::utils::get_llvm_type(
+                auto load = this->ir_builder.CreateLoad(
+                    utils::get_llvm_type(
                         this->ir_builder,
-                        binInst->dst.type.get()
-                    )}
-                );
-
-                llvm::Value *resStruct = this->ir_builder.CreateCall(
-                    smulFunc, {left, right}
-                );
-
-                dst = this->ir_builder.CreateExtractValue(
-                    resStruct, 0
-                );
-
-                llvm::Value *overflow = this->ir_builder.CreateExtractValue(
-                    resStruct, 1
+                        loadInst->dst.type
+                    ),
+                    src
                 );
+                load->setName(loadInst->dst.get_name());
+                current_temporaries[loadInst->dst.index] = load;
+                return;
             }
-            break;
-            case mir::BinaryOp::Mul_u: {
-                llvm::Function *umulFunc = llvm::Intrinsic::getOrInsertDeclaration(
-                    &this->llvm_module, 
-                    llvm::Intrinsic::umul_with_overflow,
-                    {bao::utils::get_llvm_type(
-                        this->ir_builder,
-                        binInst->dst.type.get()
-                    )}
-                );
-
-                llvm::Value *resStruct = this->ir_builder.CreateCall(
-                    umulFunc, {left, right}
-                );
-
-                dst = this->ir_builder.CreateExtractValue(
-                    resStruct, 0
-                );
 
-                llvm::Value *overflow = this->ir_builder.CreateExtractValue(
-                    resStruct, 1
-                );
-            }
-            break;
-            case mir::BinaryOp::Div_s: {
-                dst = this->ir_builder.CreateSDiv(left, right, binInst->dst.name);
-            }
-            break;
-            case mir::BinaryOp::Div_u: {
-                dst = this->ir_builder.CreateUDiv(left, right, binInst->dst.name);
-            }
-            break;
-            case mir::BinaryOp::Div_f: {
-                dst = this->ir_builder.CreateFDiv(left, right, binInst->dst.name);
-            }
-            break;
-            // TODO: Later
-            case mir::BinaryOp::Rem_s:
-            case mir::BinaryOp::Rem_u:
-            case mir::BinaryOp::Lt_s:
-            case mir::BinaryOp::Lt_u:
-                throw std::runtime_error("Lỗi nội bộ: Chưa hỗ trợ lấy số dư hoặc so sánh");
+            // Arithmatic instructions
+            case mir::InstKind::Bin: {
+                auto binInst = cast<mir::BinInst>(mir_inst);
+                auto left = get_llvm_value(binInst->left);
+                auto right = get_llvm_value(binInst->right);
+                llvm::Value* dst = nullptr;
+                switch (binInst->op) {
+                case mir::BinaryOp::Add_f: {
+                    dst = this->ir_builder.CreateFAdd(left, right, binInst->dst.get_name());
+                }
+                break;
+                case mir::BinaryOp::Add_s: {
+                    llvm::Function *saddFunc = llvm::Intrinsic::getOrInsertDeclaration(
+                        &this->llvm_module, 
+                        llvm::Intrinsic::sadd_with_overflow,
+                        {bao::utils::get_llvm_type(
+                            this->ir_builder,
+                            binInst->dst.type
+                        )}
+                    );
+
+                    llvm::Value *resStruct = this->ir_builder.CreateCall(
+                        saddFunc, {left, right}
+                    );
+
+                    dst = this->ir_builder.CreateExtractValue(
+                        resStruct, 0
+                    );
+
+                    // Not really doing anything for now
+                    llvm::Value *overflow = this->ir_builder.CreateExtractValue(
+                        resStruct, 1
+                    );
+                }
                 break;
+                case mir::BinaryOp::Add_u: {
+                    llvm::Function *uaddFunc = llvm::Intrinsic::getOrInsertDeclaration(
+                        &this->llvm_module, 
+                        llvm::Intrinsic::uadd_with_overflow,
+                        {bao::utils::get_llvm_type(
+                            this->ir_builder,
+                            binInst->dst.type
+                        )}
+                    );
+
+                    llvm::Value *resStruct = this->ir_builder.CreateCall(
+                        uaddFunc, {left, right}
+                    );
+
+                    dst = this->ir_builder.CreateExtractValue(
+                        resStruct, 0
+                    );
+
+                    llvm::Value *overflow = this->ir_builder.CreateExtractValue(
+                        resStruct, 1
+                    );
+                }
+                break;
+                case mir::BinaryOp::Sub_f: {
+                    dst = this->ir_builder.CreateFSub(left, right, binInst->dst.get_name());
+                }
+                break;
+                case mir::BinaryOp::Sub_s: {
+                    llvm::Function *ssubFunc = llvm::Intrinsic::getOrInsertDeclaration(
+                        &this->llvm_module, 
+                        llvm::Intrinsic::ssub_with_overflow,
+                        {bao::utils::get_llvm_type(
+                            this->ir_builder,
+                            binInst->dst.type
+                        )}
+                    );
+
+                    llvm::Value *resStruct = this->ir_builder.CreateCall(
+                        ssubFunc, {left, right}
+                    );
+
+                    dst = this->ir_builder.CreateExtractValue(
+                        resStruct, 0
+                    );
+
+                    llvm::Value *overflow = this->ir_builder.CreateExtractValue(
+                        resStruct, 1
+                    );
+                }
+                break;
+                case mir::BinaryOp::Sub_u: {
+                    llvm::Function *usubFunc = llvm::Intrinsic::getOrInsertDeclaration(
+                        &this->llvm_module, 
+                        llvm::Intrinsic::usub_with_overflow,
+                        {bao::utils::get_llvm_type(
+                            this->ir_builder,
+                            binInst->dst.type
+                        )}
+                    );
+
+                    llvm::Value *resStruct = this->ir_builder.CreateCall(
+                        usubFunc, {left, right}
+                    );
+
+                    dst = this->ir_builder.CreateExtractValue(
+                        resStruct, 0
+                    );
+
+                    llvm::Value *overflow = this->ir_builder.CreateExtractValue(
+                        resStruct, 1
+                    );
+                }
+                break;
+                case mir::BinaryOp::Mul_f: {
+                    dst = this->ir_builder.CreateFMul(left, right, binInst->dst.get_name());
+                }
+                break;
+                case mir::BinaryOp::Mul_s: {
+                    llvm::Function *smulFunc = llvm::Intrinsic::getOrInsertDeclaration(
+                        &this->llvm_module, 
+                        llvm::Intrinsic::smul_with_overflow,
+                        {bao::utils::get_llvm_type(
+                            this->ir_builder,
+                            binInst->dst.type
+                        )}
+                    );
+
+                    llvm::Value *resStruct = this->ir_builder.CreateCall(
+                        smulFunc, {left, right}
+                    );
+
+                    dst = this->ir_builder.CreateExtractValue(
+                        resStruct, 0
+                    );
+
+                    llvm::Value *overflow = this->ir_builder.CreateExtractValue(
+                        resStruct, 1
+                    );
+                }
+                break;
+                case mir::BinaryOp::Mul_u: {
+                    llvm::Function *umulFunc = llvm::Intrinsic::getOrInsertDeclaration(
+                        &this->llvm_module, 
+                        llvm::Intrinsic::umul_with_overflow,
+                        {bao::utils::get_llvm_type(
+                            this->ir_builder,
+                            binInst->dst.type
+                        )}
+                    );
+
+                    llvm::Value *resStruct = this->ir_builder.CreateCall(
+                        umulFunc, {left, right}
+                    );
+
+                    dst = this->ir_builder.CreateExtractValue(
+                        resStruct, 0
+                    );
+
+                    llvm::Value *overflow = this->ir_builder.CreateExtractValue(
+                        resStruct, 1
+                    );
+                }
+                break;
+                case mir::BinaryOp::Div_s: {
+                    dst = this->ir_builder.CreateSDiv(left, right, binInst->dst.get_name());
+                }
+                break;
+                case mir::BinaryOp::Div_u: {
+                    dst = this->ir_builder.CreateUDiv(left, right, binInst->dst.get_name());
+                }
+                break;
+                case mir::BinaryOp::Div_f: {
+                    dst = this->ir_builder.CreateFDiv(left, right, binInst->dst.get_name());
+                }
+                break;
+                // TODO: Later
+                case mir::BinaryOp::Rem_s:
+                case mir::BinaryOp::Rem_u:
+                case mir::BinaryOp::Lt_s:
+                case mir::BinaryOp::Lt_u:
+                    throw std::runtime_error("Lỗi nội bộ: Chưa hỗ trợ lấy số dư hoặc so sánh");
+                    break;
+                }
+                dst->setName(binInst->dst.get_name());
+                current_temporaries[binInst->dst.index] = dst;
+                return;
             }
-            dst->setName(binInst->dst.name);
-            current_context[binInst->dst.name] = dst;
-            return;
+            default:
+                throw std::runtime_error("Lỗi nội bộ: Không xác định được kiểu câu lệnh");
         }
-        throw std::runtime_error("Lỗi nội bộ: Không xác định được kiểu câu lệnh");
     } catch (std::exception& e) {
         throw; // FIXME: Rethrow for now
     }
@@ -404,7 +413,7 @@ bao::Generator :: get_llvm_value(
     try {
         switch (mir_value.kind) {
         case bao::mir::ValueKind::Constant:
-            if (auto numlit = dynamic_cast<bao::PrimitiveType*>(mir_value.type.get())) {
+            if (auto numlit = dyn_cast<bao::PrimitiveType>(mir_value.type)) {
                 auto type = bao::utils::get_llvm_type(ir_builder, numlit);
                 if (type->isIntegerTy(32)) {
                     return ir_builder.getInt32(std::stoi(mir_value.name));
@@ -419,9 +428,10 @@ bao::Generator :: get_llvm_value(
                 }
             }
         case bao::mir::ValueKind::Temporary:
+            return current_temporaries.at(mir_value.index);
         case bao::mir::ValueKind::Variable:
             // In faith I trust this won't break (pls don't break)
-            return current_context.at(mir_value.name);
+            return current_context.at(mir_value.symbol);
         default:
             ;
         }
@@ -0,0 +1,133 @@
+#include <bao/filereader/buffer.h>
+#include <format>
+#include <stdexcept>
+#include <utility>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+using std::runtime_error;
+using std::format;
+
+bao::SourceBuffer::SourceBuffer(SourceBuffer&& other) noexcept {
+    *this = std::move(other);
+}
+
+auto
+bao::SourceBuffer::operator=(SourceBuffer&& other) noexcept -> bao::SourceBuffer& {
+    if (this == &other) {
+        return *this;
+    }
+    this->release();
+    this->mapped = other.mapped;
+    this->validated = other.validated;
+    this->size = other.size;
+    if (other.mapped) {
+        this->data = other.data;
+    } else {
+        // Owned content has to be re-pointed after the move (small strings live inline)
+        this->owned = std::move(other.owned);
+        this->data = this->owned.data();
+    }
+    other.data = nullptr;
+    other.size = 0;
+    other.mapped = false;
+    other.validated = false;
+    return *this;
+}
+
+bao::SourceBuffer::~SourceBuffer() {
+    this->release();
+}
+
+auto
+bao::SourceBuffer::map_file(const string& path) -> bao::SourceBuffer {
+    SourceBuffer buffer;
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw runtime_error(format("Lỗi nội bộ: gặp sự cố đọc tệp: {}", path));
+    }
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size)) {
+        CloseHandle(file);
+        throw runtime_error(format("Lỗi nội bộ: gặp sự cố đọc tệp: {}", path));
+    }
+    if (file_size.QuadPart == 0) {
+        // Nothing to map
+        CloseHandle(file);
+        return buffer;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) {
+        throw runtime_error(format("Lỗi nội bộ: gặp sự cố ánh xạ tệp: {}", path));
+    }
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping); // The view keeps the mapping alive
+    if (!view) {
+        throw runtime_error(format("Lỗi nội bộ: gặp sự cố ánh xạ tệp: {}", path));
+    }
+    buffer.data = static_cast<const char*>(view);
+    buffer.size = static_cast<size_t>(file_size.QuadPart);
+#else
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw runtime_error(format("Lỗi nội bộ: gặp sự cố đọc tệp: {}", path));
+    }
+    struct stat info{};
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw runtime_error(format("Lỗi nội bộ: gặp sự cố đọc tệp: {}", path));
+    }
+    if (info.st_size == 0) {
+        // mmap refuses zero-length mappings
+        close(fd);
+        return buffer;
+    }
+    void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping stays valid after closing the descriptor
+    if (view == MAP_FAILED) {
+        throw runtime_error(format("Lỗi nội bộ: gặp sự cố ánh xạ tệp: {}", path));
+    }
+    // The lexer walks the file front to back
+    madvise(view, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+    buffer.data = static_cast<const char*>(view);
+    buffer.size = static_cast<size_t>(info.st_size);
+#endif
+    buffer.mapped = true;
+    return buffer;
+}
+
+auto
+bao::SourceBuffer::from_string(string content) -> bao::SourceBuffer {
+    SourceBuffer buffer;
+    buffer.owned = std::move(content);
+    buffer.data = buffer.owned.data();
+    buffer.size = buffer.owned.size();
+    return buffer;
+}
+
+void
+bao::SourceBuffer::release() {
+    if (this->mapped && this->data) {
+#if defined(_WIN32)
+        UnmapViewOfFile(this->data);
+#else
+        munmap(const_cast<char*>(this->data), this->size);
+#endif
+    }
+    this->owned.clear();
+    this->data = nullptr;
+    this->size = 0;
+    this->mapped = false;
+    this->validated = false;
+}
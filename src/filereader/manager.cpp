@@ -0,0 +1,139 @@
+#include <bao/filereader/manager.h>
+#include <bao/filereader/reader.h>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <mutex>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+using std::out_of_range;
+using std::format;
+
+auto
+bao::SourceManager::global() -> bao::SourceManager& {
+    static SourceManager manager;
+    return manager;
+}
+
+auto
+bao::SourceManager::load(const string& path) -> bao::FileId {
+    const string full_path = fs::absolute(fs::path(path)).lexically_normal().string();
+    // A file rewritten since it was loaded is loaded again, a mapping of the old
+    // content would quote stale lines and fault past the end of a shorter file
+    std::error_code size_error;
+    std::error_code time_error;
+    const uintmax_t size = fs::file_size(full_path, size_error);
+    const fs::file_time_type modified = fs::last_write_time(full_path, time_error);
+    const auto unchanged = [&](const FileId id) {
+        return !size_error && !time_error && this->files[id]->size == size && this->files[id]->modified == modified;
+    };
+    {
+        std::shared_lock lock(this->mutex);
+        if (const auto it = this->ids.find(full_path); it != this->ids.end() && unchanged(it->second)) {
+            return it->second;
+        }
+    }
+
+    // Read outside of the lock, another thread may be loading a different file
+    auto file = std::make_unique<File>();
+    file->path = full_path;
+    file->size = size;
+    file->modified = modified;
+    file->buffer = Reader(full_path).map();
+
+    // Index every line start in a single pass
+    const std::string_view content = file->buffer.view();
+    file->line_starts.push_back(0);
+    const char* begin = content.data();
+    const char* end = begin + content.size();
+    for (const char* it = begin; it < end;) {
+        const auto* newline = static_cast<const char*>(std::memchr(it, '\n', end - it));
+        if (!newline) {
+            break;
+        }
+        file->line_starts.push_back(static_cast<uint32_t>(newline - begin + 1));
+        it = newline + 1;
+    }
+
+    std::unique_lock lock(this->mutex);
+    if (const auto it = this->ids.find(full_path); it != this->ids.end() && unchanged(it->second)) {
+        return it->second; // Lost the race, keep the first copy
+    }
+    // The old content stays behind its id, lexers may still be viewing it
+    const auto id = static_cast<FileId>(this->files.size());
+    this->files.push_back(std::move(file));
+    this->ids.insert_or_assign(full_path, id);
+    return id;
+}
+
+auto
+bao::SourceManager::get_buffer(const FileId id) const -> std::string_view {
+    return this->get_file(id).buffer.view();
+}
+
+auto
+bao::SourceManager::is_validated(const FileId id) const -> bool {
+    return this->get_file(id).buffer.is_validated();
+}
+
+auto
+bao::SourceManager::get_path(const FileId id) const -> const string& {
+    return this->get_file(id).path;
+}
+
+auto
+bao::SourceManager::get_line(const FileId id, const int line) const -> std::string_view {
+    const File& file = this->get_file(id);
+    const std::string_view content = file.buffer.view();
+    if (line < 1 || static_cast<size_t>(line) > file.line_starts.size()) {
+        throw out_of_range("Lỗi: dòng nằm ngoài số dòng của tệp");
+    }
+    const uint32_t start = file.line_starts[line - 1];
+    uint32_t end = static_cast<size_t>(line) < file.line_starts.size()
+        ? file.line_starts[line] - 1 // Drop the '\n'
+        : static_cast<uint32_t>(content.size());
+    return content.substr(start, end - start);
+}
+
+auto
+bao::SourceManager::get_line(const string& path, const int line) -> std::string_view {
+    return this->get_line(this->load(path), line);
+}
+
+auto
+bao::SourceManager::line_column(const FileId id, const size_t offset) const -> std::pair<int, int> {
+    const File& file = this->get_file(id);
+    const std::string_view content = file.buffer.view();
+    if (offset > content.size()) {
+        throw out_of_range(format("Lỗi nội bộ: vị trí {} nằm ngoài tệp", offset));
+    }
+    // Last line starting at or before the offset
+    const auto it = std::upper_bound(file.line_starts.begin(), file.line_starts.end(), offset);
+    const auto line = static_cast<int>(it - file.line_starts.begin());
+    const uint32_t start = *(it - 1);
+
+    // Columns count code points, so skip UTF-8 continuation bytes
+    int column = 1;
+    for (size_t i = start; i < offset; ++i) {
+        if ((static_cast<unsigned char>(content[i]) & 0xC0) != 0x80) {
+            column++;
+        }
+    }
+    return {line, column};
+}
+
+auto
+bao::SourceManager::line_count(const FileId id) const -> size_t {
+    return this->get_file(id).line_starts.size();
+}
+
+auto
+bao::SourceManager::get_file(const FileId id) const -> const File& {
+    std::shared_lock lock(this->mutex);
+    if (id >= this->files.size()) {
+        throw out_of_range(format("Lỗi nội bộ: không tìm thấy tệp có mã {}", id));
+    }
+    return *this->files[id];
+}
@@ -2,6 +2,12 @@
 // Created by doqin on 13/05/2025.
 //
 #include <bao/filereader/reader.h>
+#include <bao/filereader/manager.h>
+#include <bao/filereader/utf8.h>
+#include <bao/parallel.h>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
 #include <utility>
 #include <fstream>
 #include <filesystem>
@@ -10,6 +16,10 @@
 #include <unicode/utypes.h>
 #include <unicode/normalizer2.h>
 #include <unicode/unistr.h>
+#include <unicode/uchar.h>
+#include <unicode/unorm2.h>
+#include <unicode/bytestream.h>
+#include <unicode/utf8.h>
 
 namespace fs = std::filesystem;
 using std::stringstream;
@@ -20,48 +30,68 @@ using std::invalid_argument;
 using std::format;
 using icu::Normalizer2;
 using icu::UnicodeString;
+using icu::StringPiece;
 using std::out_of_range;
+using std::vector;
+
+// Below this size the threads cost more than they save
+constexpr size_t PARALLEL_NORMALIZE_THRESHOLD = 1 << 20;
 
 bao::Reader::Reader(string path) {
     this->path = std::move(path);
 }
 
 string bao::Reader::read() const {
-    // --- Get the full src path ---
-    fs::path curr_dir = fs::current_path(); // Work directory
-    fs::path src_path = path; // Src path input
-    fs::path full_src_path; // Final path
-
-    // In case src path is already absolute
-    if (src_path.is_absolute()) {
-        full_src_path = src_path;
-    } else {
-        full_src_path = curr_dir / src_path;
-    }
-
-    // Make sure it's valid
-    if (!fs::exists(full_src_path)) {
-        throw invalid_argument(
-            format("Lỗi nội bộ: tệp không tồn tại: {}", full_src_path.string()));
-    }
+    const string full_src_path = resolve();
 
     // Content from file
     stringstream buffer;
     fstream file(full_src_path);
     if (!file) {
         throw runtime_error(
-            format("Lỗi nội bộ: gặp sự cố đọc tệp: {}", full_src_path.string()));
+            format("Lỗi nội bộ: gặp sự cố đọc tệp: {}", full_src_path));
     }
 
     // Gets the raw string
     string raw((istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    validate(raw);
     string contents = normalize(raw);
 
     file.close(); // Good practice
     return contents;
 }
 
-string bao::Reader::get_line(int target_line) const {
+bao::SourceBuffer bao::Reader::map() const {
+    SourceBuffer mapped = SourceBuffer::map_file(resolve());
+    const std::string_view content = mapped.view();
+    // Offsets into a source are 32-bit from here on, in line starts, tokens and diagnostics
+    if (content.size() > UINT32_MAX) {
+        throw runtime_error(
+            format("Lỗi: tệp {} quá lớn ({} byte), tối đa {} byte", path, content.size(), UINT32_MAX));
+    }
+    validate(content);
+
+    // Editors almost always save NFC already, so the mapping can be used as is
+    const size_t span = nfc_span(content);
+    if (span == content.size()) {
+        mapped.mark_validated();
+        return mapped;
+    }
+
+    // Otherwise only the part after the last safe boundary goes through the normalizer
+    const std::string_view tail = content.substr(span);
+    string contents;
+    string normalized = normalize(tail);
+    contents.reserve(span + normalized.size());
+    contents.append(content.substr(0, span));
+    contents += normalized;
+    // Normalizing well-formed UTF-8 keeps it well-formed
+    SourceBuffer normalized_buffer = SourceBuffer::from_string(std::move(contents));
+    normalized_buffer.mark_validated();
+    return normalized_buffer;
+}
+
+string bao::Reader::resolve() const {
     // --- Get the full src path ---
     fs::path curr_dir = fs::current_path(); // Work directory
     fs::path src_path = path; // Src path input
@@ -77,28 +107,27 @@ string bao::Reader::get_line(int target_line) const {
     // Make sure it's valid
     if (!fs::exists(full_src_path)) {
         throw invalid_argument(
-            format("Lỗi: tệp không tồn tại: {}", full_src_path.string()));
-    }
-
-    int current_line = 1;
-    string line;
-    fstream file(full_src_path);
-    if (!file) {
-        throw runtime_error(
-            format("Lỗi nội bộ: gặp sự cố đọc tệp: {}", full_src_path.string()));
+            format("Lỗi nội bộ: tệp không tồn tại: {}", full_src_path.string()));
     }
+    return full_src_path.string();
+}
 
-    while (getline(file, line)) {
-        if (current_line == target_line) {
-            return normalize(line);
-        }
-        current_line++;
+void bao::Reader::validate(const std::string_view content) const {
+    const size_t invalid = utf8::validate(content);
+    if (invalid == content.size()) {
+        return;
     }
+    auto [line, column] = utf8::locate(content, invalid);
+    throw runtime_error(
+        format("Lỗi: tệp {} chứa chuỗi UTF-8 không hợp lệ (Dòng {}, Cột {})", path, line, column));
+}
 
-    throw out_of_range("Lỗi: dòng nằm ngoài số dòng của tệp");
+string bao::Reader::get_line(int target_line) const {
+    // Lines are served from the indexed copy instead of rescanning the file
+    return string(SourceManager::global().get_line(resolve(), target_line));
 }
 
-string bao::Reader::normalize(const string& content) {
+string bao::Reader::normalize(const std::string_view content) {
     // Error code object
     UErrorCode errorCode = U_ZERO_ERROR;
 
@@ -110,16 +139,93 @@ string bao::Reader::normalize(const string& content) {
                 u_errorName(errorCode)));
     }
 
-    const UnicodeString source = UnicodeString::fromUTF8(content);
-    const UnicodeString normalized = normalizer->normalize(source, errorCode);
-    if (U_FAILURE(errorCode)) {
-        throw runtime_error(
-        format("Lỗi nội bộ: Gặp sự cố đồng bộ hóa chuỗi: {}",
-            u_errorName(errorCode)));
+    // Cut the content right before line breaks: '\n' always has a normalization
+    // boundary before it, so every chunk normalizes independently of its neighbours
+    const unsigned threads = parallel::worker_count();
+    vector<std::string_view> chunks;
+    if (threads > 1 && content.size() >= PARALLEL_NORMALIZE_THRESHOLD) {
+        const size_t target = std::max(content.size() / (threads * 4), PARALLEL_NORMALIZE_THRESHOLD / 4);
+        size_t start = 0;
+        while (start < content.size()) {
+            size_t cut = content.find('\n', std::min(start + target, content.size()));
+            if (cut == std::string_view::npos) {
+                cut = content.size();
+            }
+            chunks.push_back(content.substr(start, cut - start));
+            start = cut;
+        }
+    } else {
+        chunks.push_back(content);
     }
 
-    string normalizedUTF8;
-    normalized.toUTF8String(normalizedUTF8);
+    vector<string> normalized(chunks.size());
+    parallel::for_each(chunks.size(), [&](const size_t i) {
+        UErrorCode chunkError = U_ZERO_ERROR;
+        icu::StringByteSink<string> sink(&normalized[i], static_cast<int32_t>(chunks[i].size()));
+        normalizer->normalizeUTF8(
+            0, StringPiece(chunks[i].data(), static_cast<int32_t>(chunks[i].size())),
+            sink, nullptr, chunkError);
+        if (U_FAILURE(chunkError)) {
+            throw runtime_error(
+            format("Lỗi nội bộ: Gặp sự cố đồng bộ hóa chuỗi: {}",
+                u_errorName(chunkError)));
+        }
+    }, threads);
 
+    // Stitch back in source order
+    if (normalized.size() == 1) {
+        return std::move(normalized.front());
+    }
+    size_t total = 0;
+    for (const auto& chunk : normalized) {
+        total += chunk.size();
+    }
+    string normalizedUTF8;
+    normalizedUTF8.reserve(total);
+    for (const auto& chunk : normalized) {
+        normalizedUTF8 += chunk;
+    }
     return normalizedUTF8;
 }
+
+size_t bao::Reader::nfc_span(const std::string_view content) {
+    UErrorCode errorCode = U_ZERO_ERROR;
+    const Normalizer2* normalizer = Normalizer2::getNFCInstance(errorCode);
+    if (U_FAILURE(errorCode)) {
+        return 0; // Let the full normalizer report it
+    }
+
+    const auto* bytes = reinterpret_cast<const uint8_t*>(content.data());
+    const auto length = static_cast<int32_t>(content.size());
+    int32_t boundary = 0; // Last offset with a normalization boundary before it
+    uint8_t previous_class = 0;
+    int32_t i = 0;
+    while (i < length) {
+        // ASCII is always NFC and has a boundary before it, but may still compose
+        // with a combining mark that follows, so the boundary is before its last byte
+        if (bytes[i] < 0x80) {
+            while (i < length && bytes[i] < 0x80) {
+                i++;
+            }
+            boundary = i - 1;
+            previous_class = 0;
+            continue;
+        }
+        const int32_t start = i;
+        UChar32 code_point;
+        U8_NEXT(bytes, i, length, code_point);
+        if (code_point < 0) {
+            return boundary; // Malformed bytes go through the normalizer too
+        }
+        const uint8_t combining_class = u_getCombiningClass(code_point);
+        if ((combining_class != 0 && combining_class < previous_class) ||
+            u_getIntPropertyValue(code_point, UCHAR_NFC_QUICK_CHECK) != UNORM_YES) {
+            return boundary;
+        }
+        if (normalizer->hasBoundaryBefore(code_point)) {
+            boundary = start;
+        }
+        previous_class = combining_class;
+    }
+    return static_cast<size_t>(length);
+}
@@ -0,0 +1,297 @@
+#include <bao/filereader/utf8.h>
+#include <bao/simd.h>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+namespace {
+    /**
+     * Length of the well-formed sequence at i (Unicode table 3-7), 0 if it is not
+     */
+    inline size_t sequence_length(const uint8_t* bytes, const size_t size, const size_t i) {
+        const uint8_t lead = bytes[i];
+        if (lead < 0x80) {
+            return 1;
+        }
+        size_t length;
+        uint8_t low = 0x80; // Range of the second byte
+        uint8_t high = 0xBF;
+        if (lead >= 0xC2 && lead <= 0xDF) {
+            length = 2;
+        } else if (lead == 0xE0) {
+            length = 3;
+            low = 0xA0; // Overlong
+        } else if (lead == 0xED) {
+            length = 3;
+            high = 0x9F; // Surrogates
+        } else if (lead >= 0xE1 && lead <= 0xEF) {
+            length = 3;
+        } else if (lead == 0xF0) {
+            length = 4;
+            low = 0x90; // Overlong
+        } else if (lead == 0xF4) {
+            length = 4;
+            high = 0x8F; // Above U+10FFFF
+        } else if (lead >= 0xF1 && lead <= 0xF3) {
+            length = 4;
+        } else {
+            return 0;
+        }
+        if (i + length > size || bytes[i + 1] < low || bytes[i + 1] > high) {
+            return 0;
+        }
+        for (size_t k = 2; k < length; ++k) {
+            if ((bytes[i + k] & 0xC0) != 0x80) {
+                return 0;
+            }
+        }
+        return length;
+    }
+
+    size_t validate_scalar_from(const uint8_t* bytes, const size_t size, size_t i) {
+        while (i < size) {
+            // Skip ASCII a word at a time
+            if (i + 8 <= size) {
+                uint64_t word;
+                std::memcpy(&word, bytes + i, sizeof(word));
+                if ((word & 0x8080808080808080ULL) == 0) {
+                    i += 8;
+                    continue;
+                }
+            }
+            const size_t length = sequence_length(bytes, size, i);
+            if (length == 0) {
+                return i;
+            }
+            i += length;
+        }
+        return size;
+    }
+
+#if BAO_SIMD_X86
+    // Rescans from the block before the failing window, backed up to the start of a sequence
+    size_t locate_error(const uint8_t* bytes, const size_t size, const size_t block) {
+        size_t start = block >= 32 ? block - 32 : 0;
+        for (int k = 0; k < 3 && start > 0 && (bytes[start] & 0xC0) == 0x80; ++k) {
+            start--;
+        }
+        return validate_scalar_from(bytes, size, start);
+    }
+
+    size_t validate_sse2(const uint8_t* bytes, const size_t size) {
+        size_t i = 0;
+        while (i + 16 <= size) {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+            const int mask = _mm_movemask_epi8(block);
+            if (mask == 0) {
+                i += 16; // Pure ASCII
+                continue;
+            }
+            // Jump to the first non-ASCII byte and check sequences until the block is passed
+            i += static_cast<size_t>(std::countr_zero(static_cast<unsigned>(mask)));
+            const size_t stop = i + 16;
+            while (i < stop && i < size) {
+                const size_t length = sequence_length(bytes, size, i);
+                if (length == 0) {
+                    return i;
+                }
+                i += length;
+            }
+        }
+        return validate_scalar_from(bytes, size, i);
+    }
+
+    /*
+     * Keiser & Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte".
+     * Every byte is classified by the high nibble of the previous byte, the low nibble
+     * of the previous byte and its own high nibble; an error bit survives the AND of
+     * the three lookups only for an invalid pair. Third and fourth bytes are checked
+     * separately against the lead bytes two and three positions back.
+     */
+    constexpr uint8_t TOO_SHORT = 1 << 0;
+    constexpr uint8_t TOO_LONG = 1 << 1;
+    constexpr uint8_t OVERLONG_3 = 1 << 2;
+    constexpr uint8_t TOO_LARGE = 1 << 3;
+    constexpr uint8_t SURROGATE = 1 << 4;
+    constexpr uint8_t OVERLONG_2 = 1 << 5;
+    constexpr uint8_t TOO_LARGE_1000 = 1 << 6;
+    constexpr uint8_t OVERLONG_4 = 1 << 6;
+    constexpr uint8_t TWO_CONTS = 1 << 7;
+    constexpr uint8_t CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+    BAO_TARGET_AVX2
+    inline __m256i lookup16(const __m256i nibbles, const __m256i table) {
+        return _mm256_shuffle_epi8(table, nibbles);
+    }
+
+    BAO_TARGET_AVX2
+    inline __m256i high_nibbles(const __m256i input) {
+        return _mm256_and_si256(_mm256_srli_epi16(input, 4), _mm256_set1_epi8(0x0F));
+    }
+
+    // Input shifted right by N bytes, pulling the last bytes of the previous block in
+    template<int N>
+    BAO_TARGET_AVX2
+    inline __m256i previous(const __m256i input, const __m256i previous_input) {
+        return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(previous_input, input, 0x21), 16 - N);
+    }
+
+    BAO_TARGET_AVX2
+    inline __m256i check_block(const __m256i input, const __m256i previous_input) {
+        const __m256i byte_1_high_table = _mm256_setr_epi8(
+            TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+            TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+            TOO_SHORT | OVERLONG_2,
+            TOO_SHORT,
+            TOO_SHORT | OVERLONG_3 | SURROGATE,
+            static_cast<char>(TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4),
+            TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+            TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+            TOO_SHORT | OVERLONG_2,
+            TOO_SHORT,
+            TOO_SHORT | OVERLONG_3 | SURROGATE,
+            static_cast<char>(TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4));
+        const __m256i byte_1_low_table = _mm256_setr_epi8(
+            CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+            CARRY | OVERLONG_2,
+            CARRY, CARRY,
+            CARRY | TOO_LARGE,
+            CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+            CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+            CARRY | OVERLONG_2,
+            CARRY, CARRY,
+            CARRY | TOO_LARGE,
+            CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+            CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000);
+        const __m256i byte_2_high_table = _mm256_setr_epi8(
+            TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+            static_cast<char>(TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4),
+            static_cast<char>(TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE),
+            static_cast<char>(TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE),
+            static_cast<char>(TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE),
+            TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+            TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+            static_cast<char>(TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4),
+            static_cast<char>(TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE),
+            static_cast<char>(TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE),
+            static_cast<char>(TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE),
+            TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT);
+
+        const __m256i previous_1 = previous<1>(input, previous_input);
+        const __m256i special_cases = _mm256_and_si256(
+            _mm256_and_si256(
+                lookup16(high_nibbles(previous_1), byte_1_high_table),
+                lookup16(_mm256_and_si256(previous_1, _mm256_set1_epi8(0x0F)), byte_1_low_table)),
+            lookup16(high_nibbles(input), byte_2_high_table));
+
+        // Continuations two or three bytes after a 3 or 4 byte lead are expected
+        const __m256i previous_2 = previous<2>(input, previous_input);
+        const __m256i previous_3 = previous<3>(input, previous_input);
+        const __m256i is_third_byte = _mm256_subs_epu8(previous_2, _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+        const __m256i is_fourth_byte = _mm256_subs_epu8(previous_3, _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+        const __m256i must_be_continuation = _mm256_and_si256(
+            _mm256_or_si256(is_third_byte, is_fourth_byte), _mm256_set1_epi8(static_cast<char>(0x80)));
+        return _mm256_xor_si256(must_be_continuation, special_cases);
+    }
+
+    // Non-zero when the block ends in the middle of a sequence
+    BAO_TARGET_AVX2
+    inline __m256i is_incomplete(const __m256i input) {
+        const __m256i max_value = _mm256_setr_epi8(
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+        return _mm256_subs_epu8(input, max_value);
+    }
+
+    BAO_TARGET_AVX2
+    size_t validate_avx2(const uint8_t* bytes, const size_t size) {
+        // Errors are accumulated and only tested once per window to keep the loop branch free
+        constexpr size_t WINDOW = 32 * 64;
+        __m256i previous_input = _mm256_setzero_si256();
+        __m256i previous_incomplete = _mm256_setzero_si256();
+        __m256i error = _mm256_setzero_si256();
+        size_t window = 0;
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32) {
+            if (i - window == WINDOW) {
+                if (!_mm256_testz_si256(error, error)) {
+                    // The bad sequence starts in this window or the tail of the last one
+                    return locate_error(bytes, size, window);
+                }
+                window = i;
+            }
+            const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + i));
+            if (_mm256_movemask_epi8(input) == 0) {
+                // ASCII only has to finish what the last block started
+                error = _mm256_or_si256(error, previous_incomplete);
+                previous_incomplete = _mm256_setzero_si256();
+            } else {
+                // A sequence left open by the last block is finished (or rejected) by check_block
+                error = _mm256_or_si256(error, check_block(input, previous_input));
+                previous_incomplete = is_incomplete(input);
+            }
+            previous_input = input;
+        }
+        if (!_mm256_testz_si256(error, error)) {
+            return locate_error(bytes, size, window);
+        }
+        if (i < size) {
+            // Zero padding is ASCII, so a truncated last sequence shows up as too short
+            alignas(32) uint8_t tail[32] = {};
+            std::memcpy(tail, bytes + i, size - i);
+            const __m256i input = _mm256_load_si256(reinterpret_cast<const __m256i*>(tail));
+            error = check_block(input, previous_input);
+            if (!_mm256_testz_si256(error, error)) {
+                return locate_error(bytes, size, window);
+            }
+        } else if (!_mm256_testz_si256(previous_incomplete, previous_incomplete)) {
+            return locate_error(bytes, size, i);
+        }
+        return size;
+    }
+#endif
+}
+
+size_t bao::utf8::validate(const std::string_view text) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(text.data());
+#if BAO_SIMD_X86
+    if (simd::has_avx2()) {
+        return validate_avx2(bytes, text.size());
+    }
+    return validate_sse2(bytes, text.size());
+#else
+    return validate_scalar_from(bytes, text.size(), 0);
+#endif
+}
+
+size_t bao::utf8::validate_scalar(const std::string_view text) {
+    return validate_scalar_from(reinterpret_cast<const uint8_t*>(text.data()), text.size(), 0);
+}
+
+std::pair<int, int> bao::utf8::locate(const std::string_view text, const size_t offset) {
+    int line = 1;
+    size_t line_start = 0;
+    for (size_t i = 0; i < offset && i < text.size(); ++i) {
+        if (text[i] == '\n') {
+            line++;
+            line_start = i + 1;
+        }
+    }
+    int column = 1;
+    for (size_t i = line_start; i < offset && i < text.size(); ++i) {
+        if ((static_cast<unsigned char>(text[i]) & 0xC0) != 0x80) {
+            column++;
+        }
+    }
+    return {line, column};
+}
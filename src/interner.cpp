@@ -0,0 +1,57 @@
+#include <bao/interner.h>
+#include <stdexcept>
+
+auto
+bao::Interner::global() -> bao::Interner& {
+    static Interner interner;
+    return interner;
+}
+
+auto
+bao::Interner::intern(const std::string_view name) -> bao::Symbol {
+    // The shard is part of the id, so names never have to be looked up across shards
+    // The top bits pick the shard, the bottom bits the slot in it
+    const size_t hash = std::hash<std::string_view>{}(name);
+    const uint32_t index = static_cast<uint32_t>(hash >> (sizeof(size_t) * 8 - SHARD_BITS));
+    Shard& shard = this->shards[index];
+    std::lock_guard lock(shard.mutex);
+    if (shard.slots.empty()) {
+        shard.slots.resize(64);
+    }
+    size_t mask = shard.slots.size() - 1;
+    size_t slot = hash & mask;
+    for (; shard.slots[slot] != 0; slot = (slot + 1) & mask) {
+        const uint32_t local = shard.slots[slot] - 1;
+        if (shard.hashes[local] == hash && shard.names[local] == name) {
+            return static_cast<Symbol>(local << SHARD_BITS | index);
+        }
+    }
+    const auto local = static_cast<uint32_t>(shard.names.size());
+    shard.names.emplace_back(name);
+    shard.hashes.push_back(hash);
+    shard.slots[slot] = local + 1;
+    if (shard.names.size() * 2 > shard.slots.size()) {
+        // Keep the table at most half full, re-slot every name
+        shard.slots.assign(shard.slots.size() * 2, 0);
+        mask = shard.slots.size() - 1;
+        for (uint32_t i = 0; i < shard.names.size(); i++) {
+            slot = shard.hashes[i] & mask;
+            while (shard.slots[slot] != 0) {
+                slot = (slot + 1) & mask;
+            }
+            shard.slots[slot] = i + 1;
+        }
+    }
+    return static_cast<Symbol>(local << SHARD_BITS | index);
+}
+
+auto
+bao::Interner::name(const Symbol symbol) const -> std::string_view {
+    const auto id = static_cast<uint32_t>(symbol);
+    const Shard& shard = this->shards[id & (SHARDS - 1)];
+    std::lock_guard lock(shard.mutex);
+    if (symbol == NONE || id >> SHARD_BITS >= shard.names.size()) {
+        throw std::out_of_range("Lỗi nội bộ: ký hiệu không có trong bảng");
+    }
+    return shard.names[id >> SHARD_BITS];
+}
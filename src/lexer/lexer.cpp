@@ -2,260 +2,573 @@
 // Created by doqin on 13/05/2025.
 //
 
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <format>
 #include <string>
 #include <stdexcept>
+#include <bao/interner.h>
 #include <bao/lexer/lexer.h>
 #include <bao/lexer/sets.h>
-#include <unicode/uchar.h>
+#include <bao/lexer/scan.h>
+#include <bao/lexer/trie.h>
+#include <bao/lexer/unicode.h>
+#include <unicode/utf8.h>
 #include <bao/utils.h>
 #include <bao/lexer/maps.h>
 
-#define U_SENTINEL 0xFFFF
-
 using std::out_of_range;
 
+namespace {
+    // Past the end of the source, same value ICU's iterators return
+    constexpr UChar32 END_OF_SOURCE = 0xFFFF;
+
+    // Below this size the threads cost more than they save
+    constexpr size_t PARALLEL_LEX_THRESHOLD = 1 << 20;
+
+    // Replace items [first, last) of a vector by count items, moving the tail only if the counts differ
+    template<typename T, typename Iterator>
+    void splice(std::vector<T>& items, const size_t first, const size_t last, const Iterator from, const size_t count) {
+        const size_t common = std::min(last - first, count);
+        std::copy_n(from, common, items.begin() + static_cast<std::ptrdiff_t>(first));
+        if (count > common) {
+            items.insert(items.begin() + static_cast<std::ptrdiff_t>(first + common), from + static_cast<std::ptrdiff_t>(common), from + static_cast<std::ptrdiff_t>(count));
+        } else {
+            items.erase(items.begin() + static_cast<std::ptrdiff_t>(first + common), items.begin() + static_cast<std::ptrdiff_t>(last));
+        }
+    }
+
+    // Whether the line starting at an offset opens a function or a procedure
+    bool starts_declaration(const std::string_view source, const size_t line) {
+        for (const std::string_view keyword : {std::string_view("hàm"), std::string_view("thủ tục")}) {
+            if (source.substr(line, keyword.size()) != keyword) {
+                continue;
+            }
+            // The keyword has to end there, not be the start of a longer identifier
+            const size_t after = line + keyword.size();
+            if (after == source.size()) {
+                return true;
+            }
+            const auto byte = static_cast<uint8_t>(source[after]);
+            return byte < 0x80 && !std::isalnum(byte) && byte != '_';
+        }
+        return false;
+    }
+}
+
 // -- Lexer's constructor --
-bao::Lexer::Lexer(const string &source): it(UnicodeString::fromUTF8(source)) {
-    this->source = UnicodeString::fromUTF8(source);
-    this->it.setToStart();
-    this->current_line = 1;
-    this->current_column = 1;
-    this->code_point_index = 0;
+bao::Lexer::Lexer(const std::string_view source, const bool validated):
+    Lexer(source, validated, 0, 1) {}
+
+bao::Lexer::Lexer(const std::string_view source, const bool validated, const size_t begin, const int first_line):
+    source(source), validated(validated), tokens(source) {
+    // Tokens and line starts keep 32-bit offsets, past them every position would wrap
+    if (source.size() > UINT32_MAX) {
+        throw std::runtime_error(std::format("Lỗi: nguồn quá lớn ({} byte), tối đa {} byte", source.size(), UINT32_MAX));
+    }
+    this->current_line = first_line;
+    this->offset = begin;
+    this->code_point = this->decode(begin, this->next_offset);
 }
 
 // -- Lexer's methods --
-bool is_new_line(UChar32 cp);
 
-// Tokenize the source code
+// Tokenize the whole source code
 void bao::Lexer::tokenize() {
-    while (this->current_code_point() != U_SENTINEL) {
-        try {
-            this->skip_whitespace(); // Skip whitespace characters
-            const int line = this->current_line;
-            const int column = this->current_column;
-            // const int current_code_point_index = this->code_point_index; // Anchor
-            const UChar32 current_code_point = this->current_code_point();
-            const string current_utf8 = this->current_utf8();
-            if (current_code_point == U_SENTINEL) {
-                break;
-            }
+    while (true) {
+        const Token token = this->next_token();
+        this->tokens.push_back(token);
+        if (token.type == TokenType::EndOfFile) {
+            break;
+        }
+    }
+}
 
-            // Handle identifier
-            if (u_isalpha(current_code_point)) {
-                this->tokens.push_back(handle_identifier());
-                continue;
-            }
+// Tokenize parts of the source on several threads and stitch them back together
+void bao::Lexer::tokenize_parallel(const unsigned threads) {
+    if (threads <= 1 || this->offset != 0 || this->source.size() < PARALLEL_LEX_THRESHOLD) {
+        this->tokenize();
+        return;
+    }
 
-            // Handle numbers
-            if (u_isdigit(current_code_point)) {
-                this->tokens.push_back(handle_number());
-                continue;
-            }
+    // Cut at declarations roughly every target bytes. Tokens never span a line
+    // break, so every part lexes exactly as it would in the middle of the source
+    const size_t target = std::max(this->source.size() / (threads * 4), PARALLEL_LEX_THRESHOLD / 4);
+    vector<size_t> bounds{0};
+    size_t position = target;
+    while (position < this->source.size()) {
+        const void* found = std::memchr(this->source.data() + position, '\n', this->source.size() - position);
+        if (!found) {
+            break;
+        }
+        const size_t line = static_cast<const char*>(found) - this->source.data() + 1;
+        if (starts_declaration(this->source, line)) {
+            bounds.push_back(line);
+            position = line + target;
+        } else {
+            position = line;
+        }
+    }
+    bounds.push_back(this->source.size());
+    const size_t parts = bounds.size() - 1;
 
-            // Handles symbols
-            if (operators.contains(current_utf8)) {
-                this->tokens.push_back(handle_symbols());
-                continue;
-            }
+    // Line numbers the parts start at
+    vector<int> first_lines(parts + 1, 0);
+    parallel::for_each(parts, [&](const size_t i) {
+        first_lines[i + 1] = static_cast<int>(std::count(
+            this->source.begin() + static_cast<std::ptrdiff_t>(bounds[i]),
+            this->source.begin() + static_cast<std::ptrdiff_t>(bounds[i + 1]), '\n'));
+    }, threads);
+    first_lines[0] = this->current_line;
+    for (size_t i = 1; i <= parts; i++) {
+        first_lines[i] += first_lines[i - 1];
+    }
 
-            // Specific tokens
-            if (token_map.contains(this->current_utf8())) {
-                Token token = token_map.at(this->current_utf8());
-                this->next();
-                token.line = line;
-                token.column = column;
-                this->tokens.push_back(token);
-                continue;
+    vector<std::unique_ptr<Lexer>> lexers(parts);
+    parallel::for_each(parts, [&](const size_t i) {
+        lexers[i].reset(new Lexer(this->source.substr(0, bounds[i + 1]), this->validated, bounds[i], first_lines[i]));
+        lexers[i]->set_collapse_newlines(this->tokens.collapsed);
+        lexers[i]->tokenize();
+    }, threads);
+
+    // A block comment running over a cut lexed the next part from inside the comment
+    for (size_t i = 0; i + 1 < parts && lexers[i]->offset == bounds[i + 1]; i++) {
+        if (lexers[i]->open_comment) {
+            this->tokenize();
+            return;
+        }
+    }
+
+    // Stitch back in source order. A U+FFFF reads as the end of the source,
+    // so the part that met one is the last, and only the last keeps its end of file token
+    size_t total = 0;
+    for (const auto& lexer : lexers) {
+        total += lexer->tokens.size();
+    }
+    this->tokens.reserve(total);
+    for (size_t i = 0; i < parts; i++) {
+        Lexer& lexer = *lexers[i];
+        const bool last = i + 1 == parts || lexer.offset != bounds[i + 1];
+        if (!last) {
+            lexer.tokens.pop_back();
+        }
+        this->tokens.append(lexer.tokens);
+        this->exceptions.insert(this->exceptions.end(), lexer.exceptions.begin(), lexer.exceptions.end());
+        if (last) {
+            this->current_line = lexer.current_line;
+            this->seek(lexer.offset);
+            break;
+        }
+    }
+}
+
+// Re-lex the part of a token list an edit touched
+void bao::Lexer::relex(TokenList& tokens, const std::string_view source, const Edit& edit, const bool validated) {
+    vector<Token>& old_tokens = tokens.tokens;
+    vector<uint32_t>& line_starts = tokens.line_starts;
+    tokens.source = source;
+
+    if (!old_tokens.empty() && old_tokens.back().offset < edit.offset) {
+        return; // Lexing stopped at a U+FFFF before the edit
+    }
+
+    // Restart at the last line break token before the edit: no token looks past a
+    // line break, and one that is a token cannot be inside a comment
+    size_t first = std::lower_bound(old_tokens.begin(), old_tokens.end(), edit.offset,
+        [](const Token& token, const size_t at) { return token.offset < at; }) - old_tokens.begin();
+    while (first > 0 && old_tokens[first - 1].type != TokenType::Newline) {
+        first--;
+    }
+    uint32_t restart = 0;
+    size_t line_index = 0; // Line starts up to this one are kept
+    if (first > 0) {
+        first--;
+        restart = old_tokens[first].offset;
+        line_index = old_tokens[first].line - 1;
+    }
+
+    // Lex until a token past the edit is an old token moved by the edit, everything after it is then the same
+    const int64_t shift = static_cast<int64_t>(edit.inserted) - static_cast<int64_t>(edit.removed);
+    const size_t edit_end = edit.offset + edit.removed; // In the old source
+    Lexer lexer(source, validated, restart, static_cast<int>(line_index + 1));
+    lexer.set_collapse_newlines(tokens.collapsed);
+    vector<Token> part;
+    size_t last = first; // First old token that is kept
+    int64_t line_shift = 0;
+    bool synced = false;
+    while (true) {
+        const Token token = lexer.next_token();
+        while (last < old_tokens.size() && static_cast<int64_t>(old_tokens[last].offset) + shift < static_cast<int64_t>(token.offset)) {
+            last++;
+        }
+        if (last < old_tokens.size() && old_tokens[last].offset >= edit_end) {
+            const Token& old = old_tokens[last];
+            if (static_cast<int64_t>(old.offset) + shift == static_cast<int64_t>(token.offset)
+                && old.type == token.type && old.length == token.length && old.id == token.id) {
+                line_shift = static_cast<int64_t>(token.line) - static_cast<int64_t>(old.line);
+                synced = true;
+                break;
             }
+        }
+        part.push_back(token);
+        if (token.type == TokenType::EndOfFile) {
+            last = old_tokens.size();
+            break;
+        }
+    }
 
-            // Fall back to the default case
-            this->next();
-            this->tokens.push_back(Token{TokenType::Unknown, current_utf8, line, column});
+    // Line starts: the old ones up to the restart, the re-lexed ones up to the
+    // synced token (a synced newline already added the line after it), then the moved old ones
+    const uint32_t old_synced = synced ? old_tokens[last].offset : UINT32_MAX;
+    const uint32_t new_synced = synced ? static_cast<uint32_t>(old_synced + shift) : UINT32_MAX;
+    const vector<uint32_t>& relexed_lines = lexer.tokens.line_starts;
+    const size_t moved_lines = std::upper_bound(line_starts.begin(), line_starts.end(), old_synced) - line_starts.begin();
+    const size_t new_lines = std::upper_bound(relexed_lines.begin() + 1, relexed_lines.end(), new_synced) - relexed_lines.begin() - 1;
+    splice(line_starts, line_index + 1, moved_lines, relexed_lines.begin() + 1, new_lines);
+    for (size_t i = line_index + 1 + new_lines; i < line_starts.size(); i++) {
+        line_starts[i] = static_cast<uint32_t>(line_starts[i] + shift);
+    }
+
+    // Splice the re-lexed tokens in, then move the old tokens after them
+    splice(old_tokens, first, last, part.begin(), part.size());
+    if (shift != 0 || line_shift != 0) {
+        for (size_t i = first + part.size(); i < old_tokens.size(); i++) {
+            old_tokens[i].offset = static_cast<uint32_t>(old_tokens[i].offset + shift);
+            old_tokens[i].line = static_cast<uint32_t>(old_tokens[i].line + line_shift);
+        }
+    }
+
+    if (!lexer.exceptions.empty()) {
+        throw utils::ErrorList(lexer.exceptions);
+    }
+}
+
+// Produce the next token, errors are recorded and lexing resumes after them
+bao::Token bao::Lexer::next_token() {
+    while (true) {
+        try {
+            return this->lex_token();
         } catch (...) {
             this->exceptions.push_back(std::current_exception());
         }
     }
-    // Add an EndOfFile token at the end
-    this->tokens.push_back(Token{TokenType::EndOfFile, "\\0", this->current_line, this->current_column});
 }
 
-const vector<bao::Token> & bao::Lexer::get_tokens() const {
+bao::Token bao::Lexer::lex_token() {
+    while (true) {
+        // Line breaks of a run of whitespace come out one token at a time
+        if (this->offset >= this->whitespace_end) {
+            this->whitespace_end = scan::whitespace(this->source, this->offset);
+        }
+        if (const void* found = std::memchr(this->source.data() + this->offset, '\n', this->whitespace_end - this->offset)) {
+            const size_t newline = static_cast<const char*>(found) - this->source.data();
+            const uint32_t line = this->current_line;
+            this->current_line++;
+            this->tokens.add_line(static_cast<uint32_t>(newline + 1));
+            this->seek(newline + 1);
+            if (this->tokens.collapsed) {
+                this->skip_blank_lines(newline);
+            }
+            return Token{TokenType::Newline, static_cast<uint16_t>(this->offset - newline), static_cast<uint32_t>(newline), line, 0};
+        }
+        this->advance_ascii(this->whitespace_end);
+
+        // Comments are skipped like whitespace. A line comment stops before its line break, which
+        // stays a token; the line breaks inside a block comment are counted but give no Newline token
+        const size_t end = this->comment_end();
+        if (end == 0) {
+            break;
+        }
+        if (end == std::string_view::npos) {
+            const int line = this->current_line;
+            this->open_comment = true;
+            this->skip_to(this->source.size());
+            throw std::runtime_error(std::format("Lỗi: chú thích khối chưa được đóng (Dòng {})", line));
+        }
+        this->skip_to(end);
+    }
+
+    const size_t start = this->offset;
+    const UChar32 current_code_point = this->current_code_point();
+    if (current_code_point == END_OF_SOURCE) {
+        return this->make_token(TokenType::EndOfFile, start);
+    }
+
+    // Handle identifier
+    if (unicode::is_xid_start(current_code_point)) {
+        return this->handle_identifier();
+    }
+
+    // Handle numbers
+    if (unicode::is_digit(current_code_point)) {
+        return this->handle_number();
+    }
+
+    // Handles symbols
+    const std::string_view current_bytes = this->current_bytes();
+    if (operators.contains(current_bytes)) {
+        return this->handle_symbols();
+    }
+
+    // Specific tokens
+    if (const TokenType* type = token_map.find(current_bytes)) {
+        this->next();
+        return this->make_token(*type, start);
+    }
+
+    // Fall back to the default case
+    this->next();
+    return this->make_token(TokenType::Unknown, start);
+}
+
+const bao::TokenList & bao::Lexer::get_tokens() const {
     if (this->exceptions.empty()) {
         return this->tokens;
     }
     throw utils::ErrorList(this->exceptions);
 }
 
-// Get the current code point as a UTF-8 string
-string bao::Lexer::current_utf8() const {
-    const UnicodeString unicode_str(this->it.current32());
-    string utf8str;
-    unicode_str.toUTF8String(utf8str);
-    return utf8str;
+// Make a token spanning from start to the current position
+bao::Token bao::Lexer::make_token(const TokenType type, const size_t start, const uint32_t id) const {
+    const size_t length = this->offset - start;
+    if (length > UINT16_MAX) {
+        throw std::runtime_error(std::format("Lỗi: token quá dài (Dòng {})", this->current_line));
+    }
+    return Token{
+        type,
+        static_cast<uint16_t>(length),
+        static_cast<uint32_t>(start),
+        static_cast<uint32_t>(this->current_line),
+        id
+    };
+}
+
+// Get the bytes of the current code point
+std::string_view bao::Lexer::current_bytes() const {
+    return this->source.substr(this->offset, this->next_offset - this->offset);
 }
 
-// Get the current code point as a UChar32
-UChar32 bao::Lexer::current_code_point() const {
-    return this->it.current32();
+// Decode the code point starting at a byte offset
+UChar32 bao::Lexer::decode(const size_t at, size_t &end) const {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(this->source.data());
+    if (at >= this->source.size()) {
+        end = at;
+        return END_OF_SOURCE;
+    }
+    if (bytes[at] < 0x80) {
+        end = at + 1;
+        return bytes[at];
+    }
+    size_t i = at;
+    UChar32 cp;
+    if (this->validated) {
+        U8_NEXT_UNSAFE(bytes, i, cp);
+    } else {
+        // Ill-formed bytes read as U+FFFD, like UnicodeString::fromUTF8 does
+        U8_NEXT_OR_FFFD(bytes, i, this->source.size(), cp);
+    }
+    end = i;
+    return cp;
 }
 
 // Get the next code point
 void bao::Lexer::next() {
-    if (this->it.hasNext()) {
-        this->code_point_index++;
-        this->it.next32();
-        this->current_column++;
+    if (this->has_next()) {
+        this->offset = this->next_offset;
+        this->code_point = this->decode(this->offset, this->next_offset);
     } else {
         // If no code point is available, throw an exception
         throw out_of_range("Lỗi nội bộ: Không còn mã điểm nào để đọc");
     }
 }
 
-// Peek at the next code point without advancing the iterator
-string bao::Lexer::peek() const {
-    if (StringCharacterIterator copy(it); copy.hasNext()) {
-        const UChar32 code_point = copy.next32();
-        string utf8str;
-        const UnicodeString unicode_str(code_point);
-        unicode_str.toUTF8String(utf8str);
-        return utf8str;
+// Peek at the bytes of the next code point without advancing, empty at the end
+std::string_view bao::Lexer::peek() const {
+    if (this->has_next()) {
+        size_t end;
+        static_cast<void>(this->decode(this->next_offset, end));
+        return this->source.substr(this->next_offset, end - this->next_offset);
     }
     // If no code point is available, throw an exception
     throw out_of_range("Lỗi nội bộ: Không còn mã điểm nào để đọc");
 }
 
-// Skip whitespace characters and newlines
-void bao::Lexer::skip_whitespace() {
-    while (this->it.hasNext() && (this->current_utf8() == " " || is_new_line(this->current_code_point()))) {
-        if (is_new_line(this->current_code_point())) {
-            this->tokens.push_back(bao::Token{bao::TokenType::Newline, "\\n", this->current_line, this->current_column});
-            this->current_line++;
-            this->current_column = 0;
+// Jump to the end of a run of ASCII bytes
+void bao::Lexer::advance_ascii(const size_t end) {
+    if (end == this->offset) {
+        return;
+    }
+    this->offset = end;
+    this->code_point = this->decode(end, this->next_offset);
+}
+
+// Move forward to a byte offset over text that may hold line breaks, counting them
+void bao::Lexer::skip_to(const size_t end) {
+    size_t position = this->offset;
+    while (const void* found = std::memchr(this->source.data() + position, '\n', end - position)) {
+        const size_t newline = static_cast<const char*>(found) - this->source.data();
+        this->current_line++;
+        this->tokens.add_line(static_cast<uint32_t>(newline + 1));
+        position = newline + 1;
+    }
+    this->seek(end);
+}
+
+// Byte offset right after the comment at the current position, 0 if none starts here
+// and npos if it is a block comment that is never closed
+size_t bao::Lexer::comment_end() const {
+    if (this->code_point != '/' || this->offset + 1 >= this->source.size()) {
+        return 0;
+    }
+    const char* data = this->source.data();
+    const size_t size = this->source.size();
+    if (data[this->offset + 1] == '/') {
+        // A line comment ends at the line break, which is not part of it
+        const void* found = std::memchr(data + this->offset + 2, '\n', size - this->offset - 2);
+        return found ? static_cast<const char*>(found) - data : size;
+    }
+    if (data[this->offset + 1] == '*') {
+        // Only the '*' bytes can close a block comment, the rest is never looked at
+        size_t position = this->offset + 2;
+        while (const void* found = std::memchr(data + position, '*', size - position)) {
+            const size_t star = static_cast<const char*>(found) - data;
+            if (star + 1 < size && data[star + 1] == '/') {
+                return star + 2;
+            }
+            position = star + 1;
         }
-        try {
-            this->next();
-        } catch ([[maybe_unused]] out_of_range &e) {
-            throw;
+        return std::string_view::npos;
+    }
+    return 0;
+}
+
+// Swallow the blank and comment-only lines after a line break, as long as the token can cover them
+void bao::Lexer::skip_blank_lines(const size_t newline) {
+    const size_t limit = newline + UINT16_MAX;
+    while (true) {
+        const size_t blank = scan::whitespace(this->source, this->offset);
+        if (blank > limit) {
+            return;
         }
+        this->skip_to(blank);
+        // An unclosed block comment is left for the next token to report
+        const size_t end = this->comment_end();
+        if (end == 0 || end == std::string_view::npos || end > limit) {
+            return;
+        }
+        this->skip_to(end);
     }
 }
 
-// Seek to a specific code point index
-void bao::Lexer::seek(const int code_point_index) {
-    it.setToStart(); // Reset iterator to the start
-    int i;
-    for (i = 0; i < code_point_index && it.hasNext(); ++i) {
-        it.next32(); // Move to the next code point
+// Skip letters, digits and underscores
+void bao::Lexer::skip_word() {
+    while (true) {
+        this->advance_ascii(scan::identifier(this->source, this->offset));
+        // The ASCII run stops at anything else, only a non-ASCII identifier character continues the word
+        if (this->code_point < 0x80 || !this->has_next() || !unicode::is_xid_continue(this->code_point)) {
+            return;
+        }
+        this->next();
     }
-    if (i != code_point_index) {
+}
+
+// Seek to a specific byte offset, which has to be the start of a code point
+void bao::Lexer::seek(const size_t byte_offset) {
+    if (byte_offset > this->source.size()) {
         throw out_of_range("Lỗi nội bộ: Index mã điểm nằm ngoài phạm vi");
     }
+    this->offset = byte_offset;
+    this->code_point = this->decode(byte_offset, this->next_offset);
 }
 
 // Handle identifiers
 bao::Token bao::Lexer::handle_identifier() {
-    try {
-        const int line = this->current_line;
-        const int column = this->current_column;
-        string identifier;
-        // Get first identifier
-        while (this->it.hasNext() && (u_isalnum(this->current_code_point()) || this->current_utf8() == "_")) {
-            identifier += this->current_utf8();
-            this->next();
-        }
-        while (this->it.hasNext() && this->current_utf8() == " ") {
-            this->next();
-        }
-        // Handles multi-word keywords
-        if (u_isalpha(this->current_code_point())) {
-            const int anchor = this->code_point_index; // In case this doesn't work out
-            const int anchor_line = this->current_line;
-            const int anchor_column = this->current_column;
-            string second_identifier;
-            while (this->it.hasNext() && (u_isalnum(this->current_code_point()) || this->current_utf8() == "_")) {
-                second_identifier += this->current_utf8();
+    // Get first identifier, its code points are contiguous in the source
+    const size_t start = this->offset;
+    this->skip_word();
+    const std::string_view identifier = this->source.substr(start, this->offset - start);
+
+    // Handles multi-word keywords, only reading on while a longer keyword is still possible
+    const KeywordTrie& trie = KeywordTrie::global();
+    const uint32_t first = trie.step(KeywordTrie::ROOT, identifier);
+    if (first != KeywordTrie::NONE && trie.has_children(first)) {
+        uint32_t node = first;
+        uint32_t matched = KeywordTrie::NONE; // Longest multi-word keyword found
+        size_t matched_offset = this->offset;
+        while (node != KeywordTrie::NONE && trie.has_children(node)) {
+            while (this->has_next() && this->code_point == ' ') {
                 this->next();
             }
-            if (keywords.contains(format("{} {}", identifier, second_identifier))) {
-                return Token{TokenType::Keyword, format("{} {}", identifier, second_identifier), line, column};
+            if (!unicode::is_xid_start(this->code_point)) {
+                break;
+            }
+            const size_t word_start = this->offset;
+            this->skip_word();
+            node = trie.step(node, this->source.substr(word_start, this->offset - word_start));
+            if (node != KeywordTrie::NONE && trie.keyword(node) != KeywordTrie::NONE) {
+                matched = trie.keyword(node);
+                matched_offset = this->offset;
             }
-            // Fall back
-            this->code_point_index = anchor;
-            this->current_line = anchor_line;
-            this->current_column = anchor_column;
-            this->seek(anchor);
         }
-
-        // Special identifier
-        if (identifier == "E") {
-            return Token{TokenType::Operator, identifier, line, column};
+        // Back to the end of the keyword, or of the first word (only spaces were crossed)
+        this->seek(matched_offset);
+        if (matched != KeywordTrie::NONE) {
+            return this->make_token(TokenType::Keyword, start, matched);
         }
+    }
 
-        // Handles single-word keyword
-        if (keywords.contains(identifier)) {
-            return Token{TokenType::Keyword, identifier, line, column};
-        }
+    // Special identifier
+    if (identifier == "E") {
+        return this->make_token(TokenType::Operator, start, static_cast<uint32_t>(Operator::Of));
+    }
 
-        // Else is just an identifier
-        return Token{TokenType::Identifier, identifier, line, column};
-    } catch ([[maybe_unused]] out_of_range &e) {
-        throw;
+    // Handles single-word keyword
+    if (first != KeywordTrie::NONE && trie.keyword(first) != KeywordTrie::NONE) {
+        return this->make_token(TokenType::Keyword, start, trie.keyword(first));
     }
+
+    // Else is just an identifier, named by its symbol from now on
+    const Symbol symbol = Interner::global().intern(identifier);
+    return this->make_token(TokenType::Identifier, start, static_cast<uint32_t>(symbol));
 }
 
 // Handle numbers
 bao::Token bao::Lexer::handle_number() {
-    try {
-        const int line = this->current_line;
-        const int column = this->current_column;
-        string number;
-        number += this->current_utf8();
-        this->next();
-        bool is_float = false;
-        // Handles both integers and floats
-        while (this->it.hasNext() && u_isdigit(this->current_code_point()) || (this->current_utf8() == "." && !is_float)) {
-            // If encounters a dot, it becomes a float
-            if (this->current_utf8() == ".") {
-                is_float = true;
-                number += this->current_utf8();
-                this->next();
-                continue;
-            }
-            // Otherwise, it's a digit
-            number += this->current_utf8();
-            this->next();
+    const size_t start = this->offset;
+    this->next();
+    bool is_float = false;
+    // Handles both integers and floats
+    while (true) {
+        this->advance_ascii(scan::digits(this->source, this->offset));
+        if (!((this->has_next() && unicode::is_digit(this->code_point)) || (this->code_point == '.' && !is_float))) {
+            break;
+        }
+        // If encounters a dot, it becomes a float
+        if (this->code_point == '.') {
+            is_float = true;
         }
-        return Token{TokenType::Literal, number, line, column};
-    } catch ([[maybe_unused]] out_of_range& e) {
-        throw;
+        this->next();
     }
+    return this->make_token(TokenType::Literal, start);
 }
 
 bao::Token bao::Lexer::handle_symbols() {
-    try {
-        const int line = this->current_line;
-        const int column = this->current_column;
-        // Check for double operators
-        if (const string double_operator = this->current_utf8() + this->peek(); operators.contains(double_operator)) {
+    const size_t start = this->offset;
+    // Check for double operators
+    if (const std::string_view following = this->peek(); !following.empty()) {
+        const std::string_view double_operator = this->source.substr(start, this->current_bytes().size() + following.size());
+        if (const Operator* op = operators.find(double_operator)) {
             this->next();
             this->next();
-            return Token{TokenType::Operator, double_operator, line, column};
+            return this->make_token(TokenType::Operator, start, static_cast<uint32_t>(*op));
         }
-
-        // Otherwise, it's a single operator
-        const string op = this->current_utf8(); // Fixed cuz me is dumb
-        this->next();
-        return Token{TokenType::Operator, op, line, column};
-    } catch ([[maybe_unused]] out_of_range &e) {
-        throw;
     }
-}
 
-bool is_new_line(const UChar32 cp) {
-    return cp == 0x000A; // LF
-           // cp == 0x000D || // CR
-           // cp == 0x000C || // FF
-           // cp == 0x0085 || // NEL
-           // cp == 0x2028 || // Line Separator
-           // cp == 0x2029;   // Paragraph Separator
+    // Otherwise, it's a single operator
+    const Operator op = operators.at(this->current_bytes());
+    this->next();
+    return this->make_token(TokenType::Operator, start, static_cast<uint32_t>(op));
 }
@@ -0,0 +1,140 @@
+#include <bao/lexer/scan.h>
+#include <bao/simd.h>
+#include <bit>
+#include <cstdint>
+
+namespace {
+    // Every class describes the same byte set three times: scalar, 16 and 32 lanes.
+    // Signed compares keep bytes >= 0x80 out of every class.
+    struct Whitespace {
+        static bool scalar(const uint8_t c) {
+            return c == ' ' || c == '\n';
+        }
+#if BAO_SIMD_X86
+        static unsigned sse2(const __m128i block) {
+            const __m128i space = _mm_cmpeq_epi8(block, _mm_set1_epi8(' '));
+            const __m128i newline = _mm_cmpeq_epi8(block, _mm_set1_epi8('\n'));
+            return static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(space, newline)));
+        }
+
+        BAO_TARGET_AVX2
+        static unsigned avx2(const __m256i block) {
+            const __m256i space = _mm256_cmpeq_epi8(block, _mm256_set1_epi8(' '));
+            const __m256i newline = _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\n'));
+            return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_or_si256(space, newline)));
+        }
+#endif
+    };
+
+    struct Digit {
+        static bool scalar(const uint8_t c) {
+            return static_cast<uint8_t>(c - '0') < 10;
+        }
+#if BAO_SIMD_X86
+        static __m128i lanes(const __m128i block) {
+            return _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8('0' - 1)),
+                                 _mm_cmplt_epi8(block, _mm_set1_epi8('9' + 1)));
+        }
+
+        static unsigned sse2(const __m128i block) {
+            return static_cast<unsigned>(_mm_movemask_epi8(lanes(block)));
+        }
+
+        BAO_TARGET_AVX2
+        static __m256i lanes(const __m256i block) {
+            return _mm256_and_si256(_mm256_cmpgt_epi8(block, _mm256_set1_epi8('0' - 1)),
+                                    _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), block));
+        }
+
+        BAO_TARGET_AVX2
+        static unsigned avx2(const __m256i block) {
+            return static_cast<unsigned>(_mm256_movemask_epi8(lanes(block)));
+        }
+#endif
+    };
+
+    struct Word {
+        static bool scalar(const uint8_t c) {
+            // Setting 0x20 folds upper case onto lower case
+            return Digit::scalar(c) || c == '_' || static_cast<uint8_t>((c | 0x20) - 'a') < 26;
+        }
+#if BAO_SIMD_X86
+        static unsigned sse2(const __m128i block) {
+            const __m128i lower = _mm_or_si128(block, _mm_set1_epi8(0x20));
+            const __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                                 _mm_cmplt_epi8(lower, _mm_set1_epi8('z' + 1)));
+            const __m128i underscore = _mm_cmpeq_epi8(block, _mm_set1_epi8('_'));
+            return static_cast<unsigned>(_mm_movemask_epi8(
+                _mm_or_si128(_mm_or_si128(letter, underscore), Digit::lanes(block))));
+        }
+
+        BAO_TARGET_AVX2
+        static unsigned avx2(const __m256i block) {
+            const __m256i lower = _mm256_or_si256(block, _mm256_set1_epi8(0x20));
+            const __m256i letter = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+                                                    _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lower));
+            const __m256i underscore = _mm256_cmpeq_epi8(block, _mm256_set1_epi8('_'));
+            return static_cast<unsigned>(_mm256_movemask_epi8(
+                _mm256_or_si256(_mm256_or_si256(letter, underscore), Digit::lanes(block))));
+        }
+#endif
+    };
+
+    template<typename Class>
+    size_t run_scalar(const uint8_t* bytes, const size_t size, size_t i) {
+        while (i < size && Class::scalar(bytes[i])) {
+            i++;
+        }
+        return i;
+    }
+
+#if BAO_SIMD_X86
+    template<typename Class>
+    size_t run_sse2(const uint8_t* bytes, const size_t size, size_t i) {
+        for (; i + 16 <= size; i += 16) {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+            if (const unsigned outside = ~Class::sse2(block) & 0xFFFF; outside != 0) {
+                return i + std::countr_zero(outside);
+            }
+        }
+        return run_scalar<Class>(bytes, size, i);
+    }
+
+    template<typename Class>
+    BAO_TARGET_AVX2
+    size_t run_avx2(const uint8_t* bytes, const size_t size, size_t i) {
+        for (; i + 32 <= size; i += 32) {
+            const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + i));
+            if (const unsigned outside = ~Class::avx2(block); outside != 0) {
+                return i + std::countr_zero(outside);
+            }
+        }
+        return run_sse2<Class>(bytes, size, i);
+    }
+#endif
+
+    template<typename Class>
+    size_t run(const std::string_view text, const size_t from) {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(text.data());
+#if BAO_SIMD_X86
+        if (bao::simd::has_avx2()) {
+            return run_avx2<Class>(bytes, text.size(), from);
+        }
+        return run_sse2<Class>(bytes, text.size(), from);
+#else
+        return run_scalar<Class>(bytes, text.size(), from);
+#endif
+    }
+}
+
+size_t bao::scan::whitespace(const std::string_view text, const size_t from) {
+    return run<Whitespace>(text, from);
+}
+
+size_t bao::scan::identifier(const std::string_view text, const size_t from) {
+    return run<Word>(text, from);
+}
+
+size_t bao::scan::digits(const std::string_view text, const size_t from) {
+    return run<Digit>(text, from);
+}
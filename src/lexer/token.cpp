@@ -0,0 +1,44 @@
+#include <bao/lexer/token.h>
+#include <bao/lexer/sets.h>
+#include <cstring>
+#include <stdexcept>
+#include <unicode/utf8.h>
+
+auto
+bao::TokenList::text(const Token& token) const -> std::string_view {
+    if (token.type == TokenType::Keyword) {
+        // The source may have more than one space between the words
+        return keywords.keys()[token.id];
+    }
+    return this->source.substr(token.offset, token.length);
+}
+
+auto
+bao::TokenList::column(const Token& token) const -> int {
+    return this->column(token, this->line_starts[token.line - 1], 1);
+}
+
+auto
+bao::TokenList::column(const Token& token, const uint32_t from_offset, int from_column) const -> int {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(this->source.data());
+    // Step the way the lexer decodes, so an ill-formed sequence counts as one code point
+    for (int32_t i = static_cast<int32_t>(from_offset); i < static_cast<int32_t>(token.offset); from_column++) {
+        U8_FWD_1(bytes, i, static_cast<int32_t>(token.offset));
+    }
+    return from_column;
+}
+
+auto
+bao::TokenList::line(const int line) const -> std::string_view {
+    if (line < 1 || static_cast<size_t>(line) > this->line_starts.size()) {
+        throw std::out_of_range("Lỗi: dòng nằm ngoài số dòng của tệp");
+    }
+    const uint32_t start = this->line_starts[line - 1];
+    if (static_cast<size_t>(line) < this->line_starts.size()) {
+        return this->source.substr(start, this->line_starts[line] - 1 - start); // Drop the '\n'
+    }
+    // A lexer pulled on demand may not have reached the end of its last line yet
+    const std::string_view rest = this->source.substr(start);
+    const void* newline = std::memchr(rest.data(), '\n', rest.size());
+    return newline ? rest.substr(0, static_cast<const char*>(newline) - rest.data()) : rest;
+}
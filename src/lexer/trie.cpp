@@ -0,0 +1,43 @@
+#include <bao/lexer/trie.h>
+#include <bao/lexer/sets.h>
+
+bao::KeywordTrie::KeywordTrie(const std::span<const std::string_view> keywords) {
+    this->nodes.emplace_back(); // Root
+    for (uint32_t index = 0; index < keywords.size(); index++) {
+        const std::string_view keyword = keywords[index];
+        uint32_t node = ROOT;
+        size_t start = 0;
+        while (start <= keyword.size()) {
+            size_t end = keyword.find(' ', start);
+            if (end == std::string_view::npos) {
+                end = keyword.size();
+            }
+            const std::string_view word = keyword.substr(start, end - start);
+            if (const auto it = this->nodes[node].children.find(word); it != this->nodes[node].children.end()) {
+                node = it->second;
+            } else {
+                const auto child = static_cast<uint32_t>(this->nodes.size());
+                this->nodes[node].children.emplace(word, child);
+                this->nodes.emplace_back();
+                node = child;
+            }
+            start = end + 1;
+        }
+        this->nodes[node].keyword = index;
+    }
+}
+
+auto
+bao::KeywordTrie::global() -> const bao::KeywordTrie& {
+    static const KeywordTrie trie(keywords.keys());
+    return trie;
+}
+
+auto
+bao::KeywordTrie::step(const uint32_t node, const std::string_view word) const -> uint32_t {
+    const auto& children = this->nodes[node].children;
+    if (const auto it = children.find(word); it != children.end()) {
+        return it->second;
+    }
+    return NONE;
+}
@@ -45,16 +45,12 @@ bao::mir::Translator :: translate_function(
     Function function;
     std::string main_sym = "main"; // For most platforms
     function.name = func.get_name() == "chính" ? main_sym : func.get_name();
-    try {
-        function.return_type = func.get_return_type()->clone();
-    } catch ([[maybe_unused]] std::exception& e) {
-        throw;
-    }
+    function.return_type = func.get_return_type();
     auto [line, column] = func.pos();
     function.line = line;
     function.column = column;
     // Fall back in case of wrong main semantics
-    if (function.name == main_sym && function.return_type->get_name() != "Z32") {
+    if (function.name == main_sym && function.return_type != TypeContext::builtins().primitive(Primitive::Z32)) {
         auto [line, column] = func.pos();
         throw utils::CompilerError::new_error(
             program.name, program.path, 
@@ -63,10 +59,10 @@ bao::mir::Translator :: translate_function(
     }
     function.blocks.push_back(std::move(BasicBlock("entry")));
     // Initialize the temporary variable count for this function
-    for (const auto& stmt : func.get_stmts()) {
+    for (ast::StmtNode* stmt : func.get_stmts()) {
         try {
             // Translate each statement
-            this->translate_statement(function, stmt.get());
+            this->translate_statement(function, stmt);
         } catch ([[maybe_unused]] std::exception& e) {
             throw;
         }
@@ -80,46 +76,74 @@ bao::mir::Translator :: translate_statement(
     ast::StmtNode* stmt
 ) {
     try {
-        if (const auto ret_stmt = dynamic_cast<ast::RetStmt*>(stmt)) { // Check if the statement is a return statement
-            if (ret_stmt->get_val()) {
-                // Translate the return value expression
-                func.blocks.back()
-                    .instructions.push_back(
-                        std::make_unique<ReturnInst>(
-                            std::move(
-                                this->translate_expression(func, stmt, ret_stmt->get_val())
+        switch (stmt->get_kind()) {
+            case ast::NodeKind::RetStmt: { // Check if the statement is a return statement
+                const auto ret_stmt = cast<ast::RetStmt>(stmt);
+                if (ret_stmt->get_val()) {
+                    // Translate the return value expression
+                    func.blocks.back()
+                        .instructions.push_back(
+                            std::make_unique<ReturnInst>(
+                                std::move(
+                                    this->translate_expression(func, ret_stmt->get_val())
+                                )
                             )
+                        );
+                } else {
+                    // Handle the case where the return value is null
+                    auto inst = std::make_unique<ReturnInst>(
+                        Value(ValueKind::Constant, "rỗng", TypeContext::builtins().primitive(Primitive::Void)));
+                    func.blocks.back()
+                        .instructions.push_back(std::move(inst));
+                }
+                break;
+            }
+            case ast::NodeKind::VarDeclStmt: {
+                const auto vardecl_stmt = cast<ast::VarDeclStmt>(stmt);
+                auto& var = vardecl_stmt->get_var();
+                Value dst{
+                    ValueKind::Variable,
+                    var.get_symbol(),
+                    var.get_type()
+                };
+                // Create a stack allocated variable
+                func.blocks.back()
+                    .instructions
+                    .push_back(
+                        std::make_unique<AllocInst>(
+                            dst
                         )
                     );
-            } else {
-                // Handle the case where the return value is null
-                auto inst = std::make_unique<ReturnInst>(
-                    Value(ValueKind::Constant, "rỗng", std::make_unique<PrimitiveType>("rỗng")));
-                func.blocks.back()
-                    .instructions.push_back(std::move(inst));
+                // Store a value to it if it has an initializer
+                if (vardecl_stmt->get_val()) {
+                    auto src = 
+                        this->translate_expression(
+                            func, 
+                            vardecl_stmt->get_val()
+                        );
+                    func.blocks.back()
+                        .instructions
+                        .push_back(
+                            std::make_unique<StoreInst>(
+                                std::move(src),
+                                dst
+                            )
+                        );
+                }
+                break;
             }
-        } else if (const auto vardecl_stmt = dynamic_cast<ast::VarDeclStmt*>(stmt)) {
-            auto& var = vardecl_stmt->get_var();
-            Value dst{
-                ValueKind::Variable,
-                var.get_name(),
-                var.get_type()->clone()
-            };
-            // Create a stack allocated variable
-            func.blocks.back()
-                .instructions
-                .push_back(
-                    std::make_unique<AllocInst>(
-                        dst
-                    )
-                );
-            // Store a value to it if it has an initializer
-            if (vardecl_stmt->get_val()) {
+            case ast::NodeKind::VarAssignStmt: {
+                const auto varassign_stmt = cast<ast::VarAssignStmt>(stmt);
+                Value dst{
+                    ValueKind::Variable,
+                    varassign_stmt->get_var().get_symbol(),
+                    varassign_stmt->get_var().get_type()
+                };
+
                 auto src = 
                     this->translate_expression(
                         func, 
-                        stmt, 
-                        vardecl_stmt->get_val()
+                        varassign_stmt->get_val()
                     );
                 func.blocks.back()
                     .instructions
@@ -129,37 +153,19 @@ bao::mir::Translator :: translate_statement(
                             dst
                         )
                     );
+                break;
             }
-        } else if (const auto varassign_stmt = dynamic_cast<ast::VarAssignStmt*>(stmt)) {
-            Value dst{
-                ValueKind::Variable,
-                varassign_stmt->get_var().get_name(),
-                varassign_stmt->get_var().get_type()->clone()
-            };
-
-            auto src = 
-                this->translate_expression(
-                    func, 
-                    stmt, 
-                    varassign_stmt->get_val()
-                );
-            func.blocks.back()
-                .instructions
-                .push_back(
-                    std::make_unique<StoreInst>(
-                        std::move(src),
-                        dst
+            default: {
+                // Handle other statement types
+                auto [line, column] = stmt->pos();
+                std::cout 
+                    << std::format(
+                        "Cảnh báo: Bắt gặp kiểu câu lệnh không xác định (Dòng {}, Cột {})",
+                        line, column
                     )
-                );
-        } else {
-            // Handle other statement types
-            auto [line, column] = stmt->pos();
-            std::cout 
-                << std::format(
-                    "Cảnh báo: Bắt gặp kiểu câu lệnh không xác định (Dòng {}, Cột {})",
-                    line, column
-                )
-                << std::endl;
+                    << std::endl;
+                break;
+            }
         }
     } catch ([[maybe_unused]] std::exception& e) {
         throw;
@@ -169,203 +175,106 @@ bao::mir::Translator :: translate_statement(
 auto
 bao::mir::Translator :: translate_expression(
     Function& func, 
-    ast::StmtNode* stmt, // For some context
     ast::ExprNode* expr
 ) -> bao::mir::Value {
-    // Most basic, number literal
-    if (const auto numlitexpr = dynamic_cast<ast::NumLitExpr*>(expr)) {
-        Value value {
-            ValueKind::Constant,
-            numlitexpr->get_val(),
-            numlitexpr->get_type()->clone()
-        };
-        return std::move(value);
-    }
-    // Extract the value from a var
-    if (const auto varexpr = dynamic_cast<ast::VarExpr*>(expr)) {
-        Value dst {
-            ValueKind::Temporary,
-            "__temp" + std::to_string(func.temp_var_count++),
-            varexpr->get_type()->clone()
-        };
-        // Translation will not check for validity as it's checked in Analyzer already
-        Value src {
-            ValueKind::Variable,
-            varexpr->get_name(),
-            varexpr->get_type()->clone()
-        };
-        func.blocks.back().instructions.push_back(
-            std::make_unique<LoadInst>(
-                dst,
-                std::move(src)
-            )
-        );
-        return std::move(dst);
-    }
-    // Binary expresions
-    if (const auto binexpr = dynamic_cast<ast::BinExpr*>(expr)) {
-        auto left = translate_expression(func, stmt, binexpr->get_left());
-        auto right = translate_expression(func, stmt, binexpr->get_right());
-        auto type = binexpr->get_type();
-        Value dst {
-            ValueKind::Temporary,
-            "__temp" + std::to_string(func.temp_var_count++),
-            type->clone()
-        };
-        try {
-            utils::match(binexpr->get_op(), {
-                {
-                    "+", [&] {
-                        // Signed add
-                        if (utils::is_signed(type)) {
-                            if (utils::is_float(type)) {
-                                func.blocks.back().instructions.push_back(
-                                    std::make_unique<BinInst>(
-                                        dst,
-                                        std::move(left),
-                                        BinaryOp::Add_f,
-                                        std::move(right)
-                                    )
-                                );
-                            } else {
-                                func.blocks.back().instructions.push_back(
-                                    std::make_unique<BinInst>(
-                                        dst,
-                                        std::move(left),
-                                        BinaryOp::Add_s,
-                                        std::move(right)
-                                    )
-                                );
-                            }
-                        // Unsigned add
-                        } else {
-                            func.blocks.back().instructions.push_back(
-                                std::make_unique<BinInst>(
-                                    dst,
-                                    std::move(left),
-                                    BinaryOp::Add_u,
-                                    std::move(right)
-                                )
-                            );
-                        }
-                    }
-                },
-                {
-                    "-", [&] {
-                        if (utils::is_signed(type)) {
-                            if (utils::is_float(type)) {
-                                func.blocks.back().instructions.push_back(
-                                    std::make_unique<BinInst>(
-                                        dst,
-                                        std::move(left),
-                                        BinaryOp::Sub_f,
-                                        std::move(right)
-                                    )
-                                );
-                            } else {
-                                func.blocks.back().instructions.push_back(
-                                    std::make_unique<BinInst>(
-                                        dst,
-                                        std::move(left),
-                                        BinaryOp::Sub_s,
-                                        std::move(right)
-                                    )
-                                );
-                            }
-                        } else {
-                            func.blocks.back().instructions.push_back(
-                                std::make_unique<BinInst>(
-                                    dst,
-                                    std::move(left),
-                                    BinaryOp::Sub_u,
-                                    std::move(right)
-                                )
-                            );
-                        }
-                    }
-                },
-                {
-                    "*", [&] {
-                        if (utils::is_signed(type)) {
-                            if (utils::is_float(type)) {
-                                func.blocks.back().instructions.push_back(
-                                    std::make_unique<BinInst>(
-                                        dst,
-                                        std::move(left),
-                                        BinaryOp::Mul_f,
-                                        std::move(right)
-                                    )
-                                );
-                            } else {
-                                func.blocks.back().instructions.push_back(
-                                    std::make_unique<BinInst>(
-                                        dst,
-                                        std::move(left),
-                                        BinaryOp::Mul_s,
-                                        std::move(right)
-                                    )
-                                );
-                            }
-                        } else {
-                            func.blocks.back().instructions.push_back(
-                                std::make_unique<BinInst>(
-                                    dst,
-                                    std::move(left),
-                                    BinaryOp::Mul_u,
-                                    std::move(right)
-                                )
-                            );
-                        }
-                    }
-                },
-                {
-                    // Special operation due to IEEE-754
-                    "/", [&] {
-                        if (utils::is_signed(type)) {
-                            // Floating point numbers
-                            if (utils::is_float(type)) {
-                                func.blocks.back().instructions.push_back(
-                                    std::make_unique<BinInst>(
-                                        dst,
-                                        std::move(left),
-                                        BinaryOp::Div_f,
-                                        std::move(right)
-                                    )
-                                );
-                            // Dividing signed integers
-                            } else {
-                                func.blocks.back().instructions.push_back(
-                                    std::make_unique<BinInst>(
-                                        dst,
-                                        std::move(left),
-                                        BinaryOp::Div_s,
-                                        std::move(right)
-                                    )
-                                );
-                            }
-                        // Dividing unsigned integers
-                        } else {
-                            func.blocks.back().instructions.push_back(
-                                std::make_unique<BinInst>(
-                                    dst,
-                                    std::move(left),
-                                    BinaryOp::Div_u,
-                                    std::move(right)
-                                )
-                            );
-                        }
+    // Post-order walk over explicit stacks, generated expressions can nest far deeper
+    // than the native stack allows. Operands are translated left to right, each
+    // leaving its value for its parent
+    std::vector<std::pair<ast::ExprNode*, bool>> pending{{expr, false}}; // Node, whether its operands are done
+    std::vector<Value> values;
+    while (!pending.empty()) {
+        const auto [node, operands_done] = pending.back();
+        pending.pop_back();
+        switch (node->get_kind()) {
+            // Most basic, number literal
+            case ast::NodeKind::NumLitExpr: {
+                const auto numlitexpr = cast<ast::NumLitExpr>(node);
+                Value value {
+                    ValueKind::Constant,
+                    numlitexpr->get_val(),
+                    numlitexpr->get_type()
+                };
+                values.push_back(std::move(value));
+                break;
+            }
+            // Extract the value from a var
+            case ast::NodeKind::VarExpr: {
+                const auto varexpr = cast<ast::VarExpr>(node);
+                Value dst {
+                    static_cast<uint32_t>(func.temp_var_count++),
+                    varexpr->get_type()
+                };
+                // Translation will not check for validity as it's checked in Analyzer already
+                Value src {
+                    ValueKind::Variable,
+                    varexpr->get_symbol(),
+                    varexpr->get_type()
+                };
+                func.blocks.back().instructions.push_back(
+                    std::make_unique<LoadInst>(
+                        dst,
+                        std::move(src)
+                    )
+                );
+                values.push_back(std::move(dst));
+                break;
+            }
+            // Binary expresions
+            case ast::NodeKind::BinExpr: {
+                const auto binexpr = cast<ast::BinExpr>(node);
+                if (!operands_done) {
+                    pending.emplace_back(node, true);
+                    pending.emplace_back(binexpr->get_right(), false);
+                    pending.emplace_back(binexpr->get_left(), false);
+                    break;
+                }
+                Value right = std::move(values.back());
+                values.pop_back();
+                Value left = std::move(values.back());
+                values.pop_back();
+                auto type = binexpr->get_type();
+                Value dst {
+                    static_cast<uint32_t>(func.temp_var_count++),
+                    type
+                };
+                // Arithmetic instructions as {unsigned, signed, float}, the IEEE-754 variants are their own operations
+                BinaryOp unsigned_op, signed_op, float_op;
+                switch (binexpr->get_op()) {
+                    case ast::BinOp::Add:
+                        unsigned_op = BinaryOp::Add_u, signed_op = BinaryOp::Add_s, float_op = BinaryOp::Add_f;
+                        break;
+                    case ast::BinOp::Sub:
+                        unsigned_op = BinaryOp::Sub_u, signed_op = BinaryOp::Sub_s, float_op = BinaryOp::Sub_f;
+                        break;
+                    case ast::BinOp::Mul:
+                        unsigned_op = BinaryOp::Mul_u, signed_op = BinaryOp::Mul_s, float_op = BinaryOp::Mul_f;
+                        break;
+                    case ast::BinOp::Div:
+                        unsigned_op = BinaryOp::Div_u, signed_op = BinaryOp::Div_s, float_op = BinaryOp::Div_f;
+                        break;
+                    default: {
+                        auto [line, column] = node->pos();
+                        throw utils::CompilerError::new_error(
+                            this->module.name, this->module.path, 
+                            "Biểu thức không xác định", line, column);
                     }
                 }
-            }, [&expr, this] {
-                auto [line, column] = expr->pos();
-                throw utils::CompilerError::new_error(
-                    this->module.name, this->module.path, 
-                    "Biểu thức không xác định", line, column);
-            });
-        } catch ([[maybe_unused]] exception& e) {
-            throw;
+                BinaryOp op = !utils::is_signed(type) ? unsigned_op : utils::is_float(type) ? float_op : signed_op;
+                func.blocks.back().instructions.push_back(
+                    std::make_unique<BinInst>(
+                        dst,
+                        std::move(left),
+                        std::move(op),
+                        std::move(right)
+                    )
+                );
+                values.push_back(std::move(dst));
+                break;
+            }
+            default:
+                values.emplace_back();
+                break;
         }
-        return std::move(dst);
     }
-    return {};
+    return std::move(values.back());
 }
\ No newline at end of file
@@ -0,0 +1,532 @@
+#include <bao/parser/cache.h>
+#include <bao/filereader/buffer.h>
+#include <bao/casting.h>
+#include <bao/interner.h>
+#include <bao/phf.h>
+#include <bao/types.h>
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <unistd.h>
+#endif
+#if __has_include(<bao/build_id.h>)
+#include <bao/build_id.h>
+#endif
+
+namespace fs = std::filesystem;
+using std::format;
+using std::runtime_error;
+
+// An image is one flat block: a header, the function table, the node records
+// and the text they point into, every reference an index or an offset into it.
+// Records of a body are its statements in order, a statement followed by its
+// variable and its expression in post-order, so a body decodes in one pass
+namespace {
+    // Bump whenever the layout below or the meaning of a record changes
+    constexpr uint32_t FORMAT_VERSION = 2;
+    constexpr char MAGIC[8] = {'B', 'A', 'O', 'A', 'S', 'T', '\r', '\n'};
+    constexpr uint32_t ANALYZED = 1;
+
+    // Images of another build of the compiler are never trusted. The ID hashes
+    // every source of the binary, see tools/build_id.cmake. A build without
+    // one cannot tell itself apart from others and keeps no images
+#ifdef BAO_BUILD_ID
+    constexpr uint64_t COMPILER_BUILD = BAO_BUILD_ID;
+#else
+    constexpr uint64_t COMPILER_BUILD = 0;
+#endif
+
+    struct Header {
+        char magic[8];
+        uint32_t format; // Also tells images of the other byte order apart
+        uint32_t flags;
+        uint64_t compiler;
+        uint64_t source_hash;
+        uint64_t source_size;
+        uint32_t function_count;
+        uint32_t record_count;
+        uint32_t text_size;
+        uint32_t reserved;
+    };
+
+    struct Function {
+        uint32_t name; // Offset in the text
+        uint32_t name_length;
+        uint32_t line;
+        uint32_t column;
+        uint32_t params; // Var records right before the body
+        uint32_t body_begin; // Index of the first record of the body
+        uint32_t body_end;
+        uint32_t return_type;
+    };
+
+    struct Record {
+        bao::ast::NodeKind kind;
+        uint8_t flag; // Whether a variable is constant, the operator of a binary expression
+        uint8_t type; // See type_code()
+        uint8_t reserved;
+        uint32_t line;
+        uint32_t column;
+        uint32_t text; // Offset of a name or literal in the text
+        uint32_t length; // Of the text, of the expression after a statement
+    };
+
+    static_assert(sizeof(Header) == 56 && sizeof(Function) == 32 && sizeof(Record) == 20);
+
+    /**
+     *
+     * @param text Bytes to hash
+     * @return Hash of the bytes, eight at a time
+     */
+    uint64_t content_hash(const std::string_view text) {
+        uint64_t h = 0xCBF29CE484222325ULL ^ text.size();
+        const char* data = text.data();
+        size_t i = 0;
+        for (; i + 8 <= text.size(); i += 8) {
+            uint64_t word;
+            std::memcpy(&word, data + i, 8);
+            h = std::rotl(h ^ (word * 0x9E3779B97F4A7C15ULL), 29) * 0xBF58476D1CE4E5B9ULL;
+        }
+        uint64_t tail = 0;
+        if (i < text.size()) {
+            std::memcpy(&tail, data + i, text.size() - i);
+        }
+        h = std::rotl(h ^ (tail * 0x9E3779B97F4A7C15ULL), 29) * 0xBF58476D1CE4E5B9ULL;
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDULL;
+        return h ^ (h >> 33);
+    }
+
+    /**
+     *
+     * @param type Type of a node
+     * @return 0 for an unknown type, 1 + the index of a primitive among primitive_map's keys
+     */
+    uint8_t type_code(const bao::Type* type) {
+        if (!bao::isa<bao::PrimitiveType>(type)) {
+            return 0;
+        }
+        const auto keys = bao::primitive_map.keys();
+        const auto it = std::ranges::find(keys, type->get_name());
+        return static_cast<uint8_t>(1 + (it - keys.begin()));
+    }
+
+    class Writer {
+    public:
+        vector<Function> functions;
+        vector<Record> records;
+        string text;
+
+        uint32_t add_text(const std::string_view value) {
+            const auto offset = static_cast<uint32_t>(this->text.size());
+            this->text.append(value);
+            return offset;
+        }
+
+        void add_function(const bao::ast::FuncNode& func) {
+            auto [line, column] = func.pos();
+            const string name = func.get_name();
+            Function entry{};
+            entry.name = this->add_text(name);
+            entry.name_length = static_cast<uint32_t>(name.size());
+            entry.line = static_cast<uint32_t>(line);
+            entry.column = static_cast<uint32_t>(column);
+            entry.return_type = type_code(func.get_return_type());
+            entry.params = static_cast<uint32_t>(func.get_params().size());
+            for (const auto& param : func.get_params()) {
+                this->add_var(param);
+            }
+            entry.body_begin = static_cast<uint32_t>(this->records.size());
+            for (bao::ast::StmtNode* stmt : func.get_stmts()) {
+                this->add_statement(stmt);
+            }
+            entry.body_end = static_cast<uint32_t>(this->records.size());
+            this->functions.push_back(entry);
+        }
+
+    private:
+        void add_var(const bao::ast::VarNode& var) {
+            auto [line, column] = var.pos();
+            const string name = var.get_name();
+            this->records.push_back({
+                bao::ast::NodeKind::Var, var.is_const(), type_code(var.get_type()), 0,
+                static_cast<uint32_t>(line), static_cast<uint32_t>(column),
+                this->add_text(name), static_cast<uint32_t>(name.size())
+            });
+        }
+
+        void add_statement(bao::ast::StmtNode* stmt) {
+            using namespace bao::ast;
+            auto [line, column] = stmt->pos();
+            const size_t index = this->records.size();
+            this->records.push_back({
+                stmt->get_kind(), 0, 0, 0,
+                static_cast<uint32_t>(line), static_cast<uint32_t>(column), 0, 0
+            });
+            ExprNode* val = nullptr;
+            switch (stmt->get_kind()) {
+                case NodeKind::VarDeclStmt: {
+                    auto* decl = bao::cast<VarDeclStmt>(stmt);
+                    this->add_var(decl->get_var());
+                    val = decl->get_val();
+                    break;
+                }
+                case NodeKind::VarAssignStmt: {
+                    auto* assign = bao::cast<VarAssignStmt>(stmt);
+                    this->add_var(assign->get_var());
+                    val = assign->get_val();
+                    break;
+                }
+                case NodeKind::RetStmt:
+                    val = bao::cast<RetStmt>(stmt)->get_val();
+                    break;
+                default:
+                    throw runtime_error("Lỗi nội bộ: không thể lưu câu lệnh không rõ loại");
+            }
+            const size_t first = this->records.size();
+            if (val) {
+                this->add_expression(val);
+            }
+            this->records[index].length = static_cast<uint32_t>(this->records.size() - first);
+        }
+
+        void add_expression(const bao::ast::ExprNode* root) {
+            using namespace bao::ast;
+            // Post-order over an explicit stack, the operands of a binary expression come before it
+            vector<std::pair<const ExprNode*, bool>> stack{{root, false}};
+            while (!stack.empty()) {
+                auto [expr, expanded] = stack.back();
+                stack.pop_back();
+                if (const auto* bin = bao::dyn_cast<BinExpr>(expr); bin && !expanded) {
+                    stack.emplace_back(expr, true);
+                    stack.emplace_back(bin->get_right(), false);
+                    stack.emplace_back(bin->get_left(), false);
+                    continue;
+                }
+                auto [line, column] = expr->pos();
+                Record record{
+                    expr->get_kind(), 0, type_code(expr->get_type()), 0,
+                    static_cast<uint32_t>(line), static_cast<uint32_t>(column), 0, 0
+                };
+                string value;
+                switch (expr->get_kind()) {
+                    case NodeKind::NumLitExpr:
+                        value = bao::cast<NumLitExpr>(expr)->get_val();
+                        break;
+                    case NodeKind::VarExpr:
+                        value = bao::cast<VarExpr>(expr)->get_name();
+                        break;
+                    case NodeKind::BinExpr:
+                        record.flag = static_cast<uint8_t>(bao::cast<BinExpr>(expr)->get_op());
+                        break;
+                    default:
+                        throw runtime_error("Lỗi nội bộ: không thể lưu biểu thức không rõ loại");
+                }
+                record.text = this->add_text(value);
+                record.length = static_cast<uint32_t>(value.size());
+                this->records.push_back(record);
+            }
+        }
+    };
+
+    /**
+     * Decodes the bodies of a mapped image on first access
+     */
+    class CachedBodies final : public bao::ast::BodySource {
+        bao::SourceBuffer image;
+        string path;
+        const char* records;
+        uint32_t record_count;
+        std::string_view text;
+        mutable std::mutex mutex; // Guards the arena, bodies are decoded one at a time
+        mutable bao::Arena arena;
+
+    public:
+        CachedBodies(bao::SourceBuffer&& image, string path, const Header& header)
+            : image(std::move(image)), path(std::move(path)), record_count(header.record_count) {
+            const char* data = this->image.view().data();
+            this->records = data + sizeof(Header) + header.function_count * sizeof(Function);
+            this->text = {this->records + header.record_count * sizeof(Record), header.text_size};
+        }
+
+        [[nodiscard]] std::string_view data() const {
+            return this->image.view();
+        }
+
+        [[noreturn]] void corrupt() const {
+            throw runtime_error(format("Lỗi nội bộ: ảnh cây cú pháp bị hỏng: {}", this->path));
+        }
+
+        [[nodiscard]] Record record(const size_t index) const {
+            if (index >= this->record_count) {
+                this->corrupt();
+            }
+            Record record;
+            std::memcpy(&record, this->records + index * sizeof(Record), sizeof(Record));
+            return record;
+        }
+
+        [[nodiscard]] std::string_view text_of(const uint32_t offset, const uint32_t length) const {
+            if (offset > this->text.size() || length > this->text.size() - offset) {
+                this->corrupt();
+            }
+            return this->text.substr(offset, length);
+        }
+
+        [[nodiscard]] const bao::Type* type_of(const uint8_t code) const {
+            const bao::TypeContext& types = bao::TypeContext::builtins();
+            if (code == 0) {
+                return types.unknown();
+            }
+            const auto keys = bao::primitive_map.keys();
+            if (code > keys.size()) {
+                this->corrupt();
+            }
+            return types.primitive(keys[code - 1]);
+        }
+
+        [[nodiscard]] bao::ast::VarNode var_of(const Record& record) const {
+            if (record.kind != bao::ast::NodeKind::Var) {
+                this->corrupt();
+            }
+            const std::string_view name = this->text_of(record.text, record.length);
+            return {
+                name, bao::Interner::global().intern(name), this->type_of(record.type), record.flag != 0,
+                static_cast<int>(record.line), static_cast<int>(record.column)
+            };
+        }
+
+        [[nodiscard]] std::span<bao::ast::StmtNode* const> parse_body(const size_t begin, const size_t end) const override {
+            std::lock_guard lock(this->mutex);
+            using namespace bao::ast;
+            vector<StmtNode*> stmts;
+            for (size_t i = begin; i < end;) {
+                const Record stmt = this->record(i++);
+                const int line = static_cast<int>(stmt.line);
+                const int column = static_cast<int>(stmt.column);
+                switch (stmt.kind) {
+                    case NodeKind::VarDeclStmt:
+                    case NodeKind::VarAssignStmt: {
+                        if (i >= end) {
+                            this->corrupt();
+                        }
+                        VarNode var = this->var_of(this->record(i++));
+                        ExprNode* val = this->expression(i, stmt.length, end);
+                        stmts.push_back(stmt.kind == NodeKind::VarDeclStmt
+                            ? static_cast<StmtNode*>(this->arena.make<VarDeclStmt>(var, val, line, column))
+                            : this->arena.make<VarAssignStmt>(var, val, line, column));
+                        break;
+                    }
+                    case NodeKind::RetStmt:
+                        stmts.push_back(this->arena.make<RetStmt>(this->expression(i, stmt.length, end), line, column));
+                        break;
+                    default:
+                        this->corrupt();
+                }
+                i += stmt.length;
+            }
+            return this->arena.copy(stmts);
+        }
+
+    private:
+        /**
+         *
+         * @param first Index of the first record of the expression
+         * @param count Number of its records
+         * @param end End of the body the expression is in
+         * @return The expression, null when it has no records
+         */
+        bao::ast::ExprNode* expression(const size_t first, const size_t count, const size_t end) const {
+            using namespace bao::ast;
+            if (count > end - first) {
+                this->corrupt();
+            }
+            vector<ExprNode*> operands;
+            for (size_t i = first; i < first + count; i++) {
+                const Record record = this->record(i);
+                const int line = static_cast<int>(record.line);
+                const int column = static_cast<int>(record.column);
+                switch (record.kind) {
+                    case NodeKind::NumLitExpr:
+                        operands.push_back(this->arena.make<NumLitExpr>(
+                            this->text_of(record.text, record.length), this->type_of(record.type), line, column));
+                        break;
+                    case NodeKind::VarExpr: {
+                        const std::string_view name = this->text_of(record.text, record.length);
+                        operands.push_back(this->arena.make<VarExpr>(
+                            name, bao::Interner::global().intern(name), this->type_of(record.type), line, column));
+                        break;
+                    }
+                    case NodeKind::BinExpr: {
+                        if (operands.size() < 2 || record.flag > static_cast<uint8_t>(BinOp::Div)) {
+                            this->corrupt();
+                        }
+                        ExprNode* right = operands.back();
+                        operands.pop_back();
+                        ExprNode* left = operands.back();
+                        operands.back() = this->arena.make<BinExpr>(
+                            left, static_cast<BinOp>(record.flag), right, this->type_of(record.type), line, column);
+                        break;
+                    }
+                    default:
+                        this->corrupt();
+                }
+            }
+            if (count != 0 && operands.size() != 1) {
+                this->corrupt();
+            }
+            return count == 0 ? nullptr : operands.back();
+        }
+    };
+
+    // Several compilers may store the same image at once, e.g. under make -j
+    uint64_t process_id() {
+#if defined(_WIN32)
+        return GetCurrentProcessId();
+#else
+        return static_cast<uint64_t>(getpid());
+#endif
+    }
+}
+
+bao::AstCache::AstCache(string directory) : directory(std::move(directory)) {}
+
+auto
+bao::AstCache::image_path(const string& filename, const string& directory) const -> string {
+    const string source = (fs::path(directory) / filename).lexically_normal().string();
+    return (fs::path(this->directory) / format("{:016x}.baoast", phf::hash(source, FORMAT_VERSION))).string();
+}
+
+auto
+bao::AstCache::load(const string& filename, const string& directory, const std::string_view source,
+                    const bool analyzed) const -> std::optional<ast::Program> {
+    if (COMPILER_BUILD == 0) {
+        return std::nullopt;
+    }
+    const string path = this->image_path(filename, directory);
+    std::error_code error;
+    if (!fs::is_regular_file(path, error)) {
+        return std::nullopt;
+    }
+    SourceBuffer image;
+    try {
+        image = SourceBuffer::map_file(path);
+    } catch (const std::runtime_error&) {
+        return std::nullopt; // Unreadable images are misses too, the next store replaces them
+    }
+
+    // Cheap checks first, the source is only hashed when everything else matches
+    Header header{};
+    const std::string_view data = image.view();
+    if (data.size() < sizeof(Header)) {
+        return std::nullopt;
+    }
+    std::memcpy(&header, data.data(), sizeof(Header));
+    const uint64_t size = sizeof(Header)
+                          + static_cast<uint64_t>(header.function_count) * sizeof(Function)
+                          + static_cast<uint64_t>(header.record_count) * sizeof(Record)
+                          + header.text_size;
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0
+        || header.format != FORMAT_VERSION
+        || header.compiler != COMPILER_BUILD
+        || (header.flags & ANALYZED) != (analyzed ? ANALYZED : 0)
+        || header.source_size != source.size()
+        || size != data.size()
+        || header.source_hash != content_hash(source)) {
+        return std::nullopt;
+    }
+
+    auto bodies = std::make_unique<CachedBodies>(std::move(image), path, header);
+    const char* table = bodies->data().data() + sizeof(Header);
+    vector<ast::FuncNode> functions;
+    functions.reserve(header.function_count);
+    try {
+        for (uint32_t i = 0; i < header.function_count; i++) {
+            Function entry;
+            std::memcpy(&entry, table + i * sizeof(Function), sizeof(Function));
+            if (entry.params > entry.body_begin || entry.body_begin > entry.body_end
+                || entry.body_end > header.record_count || entry.return_type > 0xFF) {
+                bodies->corrupt();
+            }
+            vector<ast::VarNode> params;
+            params.reserve(entry.params);
+            for (uint32_t param = entry.body_begin - entry.params; param < entry.body_begin; param++) {
+                params.push_back(bodies->var_of(bodies->record(param)));
+            }
+            const std::string_view name = bodies->text_of(entry.name, entry.name_length);
+            functions.emplace_back(
+                name, Interner::global().intern(name), std::move(params),
+                bodies.get(), entry.body_begin, entry.body_end,
+                bodies->type_of(static_cast<uint8_t>(entry.return_type)),
+                static_cast<int>(entry.line), static_cast<int>(entry.column)
+            );
+        }
+    } catch (const std::runtime_error&) {
+        return std::nullopt;
+    }
+    return ast::Program(filename, directory, std::move(functions), Arena{}, std::move(bodies));
+}
+
+void
+bao::AstCache::store(const ast::Program& program, const std::string_view source, const bool analyzed) const {
+    if (COMPILER_BUILD == 0) {
+        return;
+    }
+    Writer writer;
+    writer.functions.reserve(program.funcs.size());
+    for (const ast::FuncNode& func : program.funcs) {
+        writer.add_function(func);
+    }
+
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.format = FORMAT_VERSION;
+    header.flags = analyzed ? ANALYZED : 0;
+    header.compiler = COMPILER_BUILD;
+    header.source_hash = content_hash(source);
+    header.source_size = source.size();
+    header.function_count = static_cast<uint32_t>(writer.functions.size());
+    header.record_count = static_cast<uint32_t>(writer.records.size());
+    header.text_size = static_cast<uint32_t>(writer.text.size());
+
+    fs::create_directories(this->directory);
+    const string path = this->image_path(program.name, program.path);
+    // Write next to the image and rename over it, so a concurrent load never sees half of one
+    // The temporary is named after the process and the thread, no other writer can open it
+    const string temporary = format("{}.{:x}.{:x}.tmp", path, process_id(),
+                                    std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    bool written;
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        out.write(reinterpret_cast<const char*>(writer.functions.data()),
+                  static_cast<std::streamsize>(writer.functions.size() * sizeof(Function)));
+        out.write(reinterpret_cast<const char*>(writer.records.data()),
+                  static_cast<std::streamsize>(writer.records.size() * sizeof(Record)));
+        out.write(writer.text.data(), static_cast<std::streamsize>(writer.text.size()));
+        out.close();
+        written = !out.fail();
+    }
+    std::error_code error;
+    if (written) {
+        fs::rename(temporary, path, error);
+    }
+    if (!written || error) {
+        // Leave nothing behind in the cache directory
+        std::error_code ignored;
+        fs::remove(temporary, ignored);
+        throw runtime_error(format("Lỗi nội bộ: gặp sự cố ghi tệp: {}", written ? path : temporary));
+    }
+}
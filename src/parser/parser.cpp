@@ -4,38 +4,207 @@
 #include "bao/lexer/token.h"
 #include <bao/parser/parser.h>
 #include <bao/utils.h>
+#include <bao/interner.h>
 #include <bao/types.h>
 #include <bao/parser/ast.h>
+#include <algorithm>
+#include <atomic>
+#include <iterator>
 #include <memory>
-#include <unordered_map>
+#include <mutex>
 
 using std::out_of_range;
 
-std::unordered_map<std::string, int> precedences{
-    {"hoặc",    3},
-    {"và",      6},
-    {"=",       12},
-    {"!=",      12},
-    {"<=",      25},
-    {"<",       25},
-    {">=",      25},
-    {">",       25},
-    {"+",       50},
-    {"-",       50},
-    {"*",       100},
-    {"/",       100}
+namespace {
+    // Below this many tokens the threads cost more than they save
+    constexpr size_t PARALLEL_PARSE_THRESHOLD = 1 << 16;
+
+    struct Binary {
+        bao::ast::BinOp op;
+        int precedence; // Higher binds tighter, -1 when the token is no binary operator
+    };
+
+    // The binary operator a token stands for
+    constexpr Binary binary_of(const bao::Token& token) {
+        using bao::ast::BinOp;
+        if (token.type == bao::TokenType::Keyword) {
+            switch (static_cast<bao::Keyword>(token.id)) {
+                case bao::Keyword::Or: return {BinOp::Or, 3};
+                case bao::Keyword::And: return {BinOp::And, 6};
+                default: return {BinOp::Or, -1};
+            }
+        }
+        if (token.type == bao::TokenType::Operator) {
+            switch (static_cast<bao::Operator>(token.id)) {
+                case bao::Operator::Equal: return {BinOp::Equal, 12};
+                case bao::Operator::NotEqual: return {BinOp::NotEqual, 12};
+                case bao::Operator::LessEqual: return {BinOp::LessEqual, 25};
+                case bao::Operator::Less: return {BinOp::Less, 25};
+                case bao::Operator::GreaterEqual: return {BinOp::GreaterEqual, 25};
+                case bao::Operator::Greater: return {BinOp::Greater, 25};
+                case bao::Operator::Plus: return {BinOp::Add, 50};
+                case bao::Operator::Minus: return {BinOp::Sub, 50};
+                case bao::Operator::Star: return {BinOp::Mul, 100};
+                case bao::Operator::Slash: return {BinOp::Div, 100};
+                case bao::Operator::Of: return {BinOp::Or, -1}; // Only ever between a variable and its type
+                default: return {BinOp::Or, -1};
+            }
+        }
+        return {BinOp::Or, -1};
+    }
+}
+
+/**
+ * Parses skimmed bodies from the tokens of the program, into an arena of its own
+ */
+class bao::Parser::LazyBodies final : public ast::BodySource {
+    string filename;
+    string directory;
+    const TokenList& tokens;
+    mutable std::mutex mutex; // Guards the arena, bodies are parsed one at a time
+    mutable Arena arena;
+public:
+    size_t max_nesting = DEFAULT_MAX_NESTING;
+
+    LazyBodies(string filename, string directory, const TokenList& tokens)
+        : filename(std::move(filename)), directory(std::move(directory)), tokens(tokens) {}
+
+    [[nodiscard]] std::span<ast::StmtNode* const> parse_body(const size_t begin, const size_t end) const override {
+        std::lock_guard lock(this->mutex);
+        Parser parser(this->filename, this->directory, this->tokens, begin, end + 1);
+        parser.max_nesting = this->max_nesting;
+        // Bodies are small, they share the chunks of one arena instead of each starting one
+        parser.arena = std::move(this->arena);
+        try {
+            const vector<ast::StmtNode*> stmts = parser.parse_statements();
+            // The skim ends a body at its only 'kết thúc', tokens left over would be dropped silently
+            if (parser.current().type != TokenType::EndOfFile) {
+                throw parser.error("Ký hiệu không xác định", parser.current_line(), parser.current_column());
+            }
+            const std::span<ast::StmtNode* const> body = parser.arena.copy(stmts);
+            this->arena = std::move(parser.arena);
+            return body;
+        } catch (...) {
+            this->arena = std::move(parser.arena);
+            throw;
+        }
+    }
 };
 
-bao::Parser :: Parser(const string &filename, const string &directory, const vector<Token> &tokens) : tokens(tokens) {
+bao::Parser :: Parser(const string &filename, const string &directory, Lexer &lexer) : lexer(&lexer) {
+    this->filename = filename;
+    this->directory = directory;
+    this->window[0] = this->pull();
+}
+
+bao::Parser :: Parser(const string &filename, const string &directory, const TokenList &tokens)
+    : Parser(filename, directory, tokens, 0, tokens.size()) {}
+
+bao::Parser :: Parser(const string &filename, const string &directory, const TokenList &tokens, const size_t begin, const size_t end)
+    : tokens(&tokens), position(begin), end(end) {
     this->filename = filename;
     this->directory = directory;
-    this->it = 0;
+    this->window[0] = this->pull();
 }
 
 auto
 bao::Parser :: parse_program() -> bao::ast::Program {
     vector<ast::FuncNode> functions;
     vector<exception_ptr> exceptions;
+    this->parse_declarations(functions, exceptions);
+    // Errors of the lexer come first, as they would when lexing ahead of parsing
+    if (this->lexer) {
+        if (const auto& lexer_errors = this->lexer->get_errors(); !lexer_errors.empty()) {
+            exceptions.insert(exceptions.begin(), lexer_errors.begin(), lexer_errors.end());
+        }
+    }
+    if (!exceptions.empty()) {
+        throw utils::ErrorList(exceptions);
+    }
+    return ast::Program(
+        this->filename,
+        this->directory,
+        std::move(functions),
+        std::move(this->arena),
+        std::move(this->bodies));
+}
+
+auto
+bao::Parser :: parse_program_parallel(const unsigned threads) -> bao::ast::Program {
+    if (!this->tokens || this->pulled != 1 || this->end < PARALLEL_PARSE_THRESHOLD) {
+        return this->parse_program();
+    }
+    const TokenList& list = *this->tokens;
+
+    // Skim for the declarations that start a line, a function runs up to the next one
+    vector<size_t> starts;
+    for (size_t i = 0; i < this->end; i++) {
+        const Token& token = list[i];
+        if ((token.is(Keyword::Function) || token.is(Keyword::Procedure))
+            && (i == 0 || list[i - 1].type == TokenType::Newline)) {
+            starts.push_back(i);
+        }
+    }
+    if (starts.size() < 2 || threads <= 1) {
+        return this->parse_program();
+    }
+
+    // Cut before a declaration roughly every target tokens, about four parts per thread
+    const size_t target = std::max<size_t>(this->end / (threads * 4), PARALLEL_PARSE_THRESHOLD / 4);
+    vector<size_t> bounds{0};
+    for (const size_t start : starts) {
+        if (start - bounds.back() >= target) {
+            bounds.push_back(start);
+        }
+    }
+    bounds.push_back(this->end);
+    const size_t parts = bounds.size() - 1;
+    if (parts < 2) {
+        return this->parse_program();
+    }
+
+    // A part parses alone exactly as in the whole stream as long as it has no error:
+    // each part is then a run of functions that end before the next part starts
+    vector<vector<ast::FuncNode>> functions(parts);
+    vector<Arena> arenas(parts);
+    std::atomic<bool> failed{false};
+    parallel::for_each(parts, [&](const size_t i) {
+        if (failed.load(std::memory_order_relaxed)) {
+            return;
+        }
+        Parser part(this->filename, this->directory, list, bounds[i], bounds[i + 1]);
+        part.lazy = this->lazy;
+        part.max_nesting = this->max_nesting;
+        vector<exception_ptr> exceptions;
+        part.parse_declarations(functions[i], exceptions);
+        if (!exceptions.empty()) {
+            failed.store(true, std::memory_order_relaxed);
+        }
+        arenas[i] = std::move(part.arena);
+    }, threads);
+    if (failed.load()) {
+        // Start over in order, for the errors and recovery of a sequential parse
+        functions.clear();
+        arenas.clear();
+        return this->parse_program();
+    }
+
+    vector<ast::FuncNode> program_functions;
+    program_functions.reserve(starts.size());
+    for (size_t i = 0; i < parts; i++) {
+        std::move(functions[i].begin(), functions[i].end(), std::back_inserter(program_functions));
+        this->arena.absorb(std::move(arenas[i]));
+    }
+    return ast::Program(
+        this->filename,
+        this->directory,
+        std::move(program_functions),
+        std::move(this->arena),
+        std::move(this->bodies));
+}
+
+void
+bao::Parser :: parse_declarations(vector<ast::FuncNode>& functions, vector<exception_ptr>& exceptions) {
     while (this->current().type != TokenType::EndOfFile) {
         try {
             // Skip newlines
@@ -45,32 +214,21 @@ bao::Parser :: parse_program() -> bao::ast::Program {
             }
             switch (this->current().type) {
                 case TokenType::Keyword:
-                    utils::match(this->current().value, {
-                                     // Case "thủ tục" or "hàm"
-                                     {
-                                         "hàm", [&functions, this]() {
-                                             functions.emplace_back(this->parse_function());
-                                         }
-                                     },
-                                     {
-                                         "thủ tục", [&functions, this]() {
-                                             functions.emplace_back(this->parse_procedure());
-                                         }
-                                     }
-                                 },
-                                 // Default case
-                                 [this]() {
-                                     const int line = this->current().line;
-                                     const int column = this->current().column;
-                                     throw utils::CompilerError::new_error(
-                                         this->filename, this->directory, "Ký hiệu không xác định", line, column);
-                                 });
+                    switch (static_cast<Keyword>(this->current().id)) {
+                        case Keyword::Function:
+                            functions.emplace_back(this->parse_function());
+                            break;
+                        case Keyword::Procedure:
+                            functions.emplace_back(this->parse_procedure());
+                            break;
+                        default:
+                            throw this->error("Ký hiệu không xác định", this->current_line(), this->current_column());
+                    }
                     break;
                 default:
-                    const int line = this->current().line;
-                    const int column = this->current().column;
-                    throw utils::CompilerError::new_error(
-                        this->filename, this->directory, "Ký hiệu không xác định", line, column);
+                    const int line = this->current_line();
+                    const int column = this->current_column();
+                    throw this->error("Ký hiệu không xác định", line, column);
             }
         } catch (...) {
             exceptions.push_back(std::current_exception());
@@ -80,31 +238,23 @@ bao::Parser :: parse_program() -> bao::ast::Program {
             this->next();
         }
     }
-    if (!exceptions.empty()) {
-        throw utils::ErrorList(exceptions);
-    }
-    return ast::Program(
-        this->filename,
-        this->directory,
-        std::move(functions));
 }
 
 auto
 bao::Parser :: parse_function() -> bao::ast::FuncNode {
-    const int line = this->current().line;
-    const int column = this->current().column;
+    const int line = this->current_line();
+    const int column = this->current_column();
     this->next(); // Consumes "hàm"
 
     if (this->current().type != TokenType::Identifier) {
-        throw utils::CompilerError::new_error(
-            this->filename, this->directory, "Mong đợi tên hàm ở vị trí này", this->current().line, this->current().column);
+        throw this->error("Mong đợi tên hàm ở vị trí này", this->current_line(), this->current_column());
     }
-    const string function_name = this->current().value;
+    const std::string_view function_name = this->arena.copy(this->current_value());
+    const Symbol function_symbol = this->current_symbol();
     this->next(); // Consumes identifier
 
     if (this->current().type != TokenType::LParen) {
-        throw utils::CompilerError::new_error(
-            this->filename, this->directory, "Mong đợi '(' ở vị trí này", this->current().line, this->current().column);
+        throw this->error("Mong đợi '(' ở vị trí này", this->current_line(), this->current_column());
     }
     this->next(); // Consumes '('
 
@@ -112,18 +262,16 @@ bao::Parser :: parse_function() -> bao::ast::FuncNode {
     // TODO: Implement parameters parsing
 
     if (this->current().type != TokenType::RParen) {
-        throw utils::CompilerError::new_error(
-            this->filename, this->directory, "Mong đợi ')' ở vị trí này", this->current().line, this->current().column);
+        throw this->error("Mong đợi ')' ở vị trí này", this->current_line(), this->current_column());
     }
     this->next(); // Consumes ')'
 
-    if (this->current().value != "->") {
-        throw utils::CompilerError::new_error(
-            this->filename, this->directory, "Mong đợi '->' tại vị trí này", this->current().line, this->current().column);
+    if (!this->current().is(Operator::Arrow)) {
+        throw this->error("Mong đợi '->' tại vị trí này", this->current_line(), this->current_column());
     }
     this->next(); // Consumes '->'
 
-    std::unique_ptr<Type> type = nullptr;
+    const Type* type = nullptr;
     try {
         type = parse_type();
     } catch ([[maybe_unused]] exception& e) {
@@ -131,57 +279,27 @@ bao::Parser :: parse_function() -> bao::ast::FuncNode {
     }
 
     if (this->current().type != TokenType::Newline) {
-        throw utils::CompilerError::new_error(
-            this->filename, this->directory, "Mong đợi xuống dòng tại vị trí này", this->current().line, this->current().column);
+        throw this->error("Mong đợi xuống dòng tại vị trí này", this->current_line(), this->current_column());
     }
     this->next(); // Consumes '\n'
 
-    vector<std::unique_ptr<ast::StmtNode>> stmts;
-    vector<exception_ptr> exceptions;
-    while (this->current().value != "kết thúc" || this->current().type != TokenType::EndOfFile) {
-        // Ignore newlines
-        this->skip_newlines();
-        if (this->current().value == "kết thúc" || this->current().type == TokenType::EndOfFile) {
-            break;
-        }
-        try {
-            stmts.push_back(std::move(this->parse_statement()));
-        } catch (...) {
-            exceptions.push_back(std::current_exception());
-            if (this->current().type == TokenType::EndOfFile) {
-                break;
-            }
-            this->next();
-        }
-    }
-    if (!exceptions.empty()) {
-        throw utils::ErrorList(exceptions);
-    }
-
-    if (this->current().value != "kết thúc") {
-        throw utils::CompilerError::new_error(
-            this->filename, this->directory, "Mong đợi từ khoá 'kết thúc' tại vị trí này", this->current().line, this->current().column);
-    }
-    this->next(); // Consumes 'kết thúc'
-
-    return {std::move(function_name), std::move(params), std::move(stmts), std::move(type), line, column};
+    return this->parse_body(function_name, function_symbol, std::move(params), type, line, column);
 }
 
 auto
 bao::Parser :: parse_procedure() -> bao::ast::FuncNode {
-    const int line = this->current().line;
-    const int column = this->current().column;
+    const int line = this->current_line();
+    const int column = this->current_column();
     this->next(); // Consumes "thủ tục"
 
     if (this->current().type != TokenType::Identifier) {
-        throw utils::CompilerError::new_error(
-            this->filename, this->directory, "Mong đợi tên thủ tục ở vị trí này", this->current().line, this->current().column);
+        throw this->error("Mong đợi tên thủ tục ở vị trí này", this->current_line(), this->current_column());
     }
-    const string function_name = this->current().value;
+    const std::string_view function_name = this->arena.copy(this->current_value());
+    const Symbol function_symbol = this->current_symbol();
     this->next(); // Consumes identifier
     if (this->current().type != TokenType::LParen) {
-        throw utils::CompilerError::new_error(
-            this->filename, this->directory, "Mong đợi '(' ở vị trí này", this->current().line, this->current().column);
+        throw this->error("Mong đợi '(' ở vị trí này", this->current_line(), this->current_column());
     }
     this->next(); // Consumes '('
 
@@ -189,27 +307,63 @@ bao::Parser :: parse_procedure() -> bao::ast::FuncNode {
     // TODO: Implement parameters parsing
 
     if (this->current().type != TokenType::RParen) {
-        throw utils::CompilerError::new_error(
-            this->filename, this->directory, "Mong đợi ')' ở vị trí này", this->current().line, this->current().column);
+        throw this->error("Mong đợi ')' ở vị trí này", this->current_line(), this->current_column());
     }
     this->next(); // Consumes ')'
 
     if (this->current().type != TokenType::Newline) {
-        throw utils::CompilerError::new_error(
-            this->filename, this->directory, "Mong đợi xuống dòng tại vị trí này", this->current().line, this->current().column);
+        throw this->error("Mong đợi xuống dòng tại vị trí này", this->current_line(), this->current_column());
     }
     this->next(); // Consumes '\n'
 
-    vector<std::unique_ptr<ast::StmtNode>> stmts;
+    return this->parse_body(function_name, function_symbol, std::move(params), TypeContext::builtins().primitive(Primitive::Void), line, column);
+}
+
+auto
+bao::Parser :: parse_body(
+    const std::string_view name,
+    const Symbol symbol,
+    vector<ast::VarNode>&& params,
+    const Type* return_type,
+    const int line, const int column
+) -> bao::ast::FuncNode {
+    if (this->lazy) {
+        // A body ends at the first line starting with 'kết thúc'. When a declaration,
+        // the end, or a 'kết thúc' inside a line comes first, the body is parsed now:
+        // parsing would stop at that 'kết thúc', and the errors have to show
+        const TokenList& list = *this->tokens;
+        const size_t begin = this->position - (this->pulled - this->head);
+        for (size_t i = begin; i < this->end && list[i].type != TokenType::EndOfFile; i++) {
+            const bool starts_line = list[i - 1].type == TokenType::Newline;
+            if (list[i].is(Keyword::End)) {
+                if (!starts_line) {
+                    break;
+                }
+                this->seek(i + 1);
+                return {name, symbol, std::move(params), this->lazy, begin, i, return_type, line, column};
+            }
+            if (starts_line && (list[i].is(Keyword::Function) || list[i].is(Keyword::Procedure))) {
+                break;
+            }
+        }
+    }
+    const vector<ast::StmtNode*> stmts = this->parse_statements();
+    return {name, symbol, std::move(params), this->arena.copy(stmts), return_type, line, column};
+}
+
+auto
+bao::Parser :: parse_statements() -> vector<bao::ast::StmtNode*> {
+
+    vector<ast::StmtNode*> stmts;
     vector<exception_ptr> exceptions;
-    while (this->current().value != "kết thúc" || this->current().type != TokenType::EndOfFile) {
+    while (!this->current().is(Keyword::End) || this->current().type != TokenType::EndOfFile) {
         // Ignore newlines
         this->skip_newlines();
-        if (this->current().value == "kết thúc" || this->current().type == TokenType::EndOfFile) {
+        if (this->current().is(Keyword::End) || this->current().type == TokenType::EndOfFile) {
             break;
         }
         try {
-            stmts.push_back(std::move(this->parse_statement()));
+            stmts.push_back(this->parse_statement());
         } catch (...) {
             exceptions.push_back(std::current_exception());
             if (this->current().type == TokenType::EndOfFile) {
@@ -222,37 +376,128 @@ bao::Parser :: parse_procedure() -> bao::ast::FuncNode {
         throw utils::ErrorList(exceptions);
     }
 
-    if (this->current().value != "kết thúc") {
-        throw utils::CompilerError::new_error(
-            this->filename, this->directory,
-            "Mong đợi từ khoá 'kết thúc' tại vị trí này", this->current().line, this->current().column);
+    if (!this->current().is(Keyword::End)) {
+        throw this->error("Mong đợi từ khoá 'kết thúc' tại vị trí này", this->current_line(), this->current_column());
     }
     this->next(); // Consumes 'kết thúc'
 
-    return {std::move(function_name), std::move(params), std::move(stmts), std::move(std::make_unique<PrimitiveType>("rỗng")), line, column};
+
+    return stmts;
+}
+
+bao::Parser :: ~Parser() = default;
+
+void
+bao::Parser :: set_max_nesting(const size_t depth) {
+    this->max_nesting = depth;
+    if (this->bodies) {
+        this->bodies->max_nesting = depth;
+    }
+}
+
+void
+bao::Parser :: set_lazy_bodies(const bool enabled) {
+    if (!enabled || !this->tokens) {
+        this->bodies.reset();
+        this->lazy = nullptr;
+        return;
+    }
+    if (!this->bodies) {
+        this->bodies = std::make_unique<LazyBodies>(this->filename, this->directory, *this->tokens);
+        this->bodies->max_nesting = this->max_nesting;
+    }
+    this->lazy = this->bodies.get();
+}
+
+auto
+bao::Parser :: current() -> const bao::Token& {
+    return this->window[this->head % LOOKAHEAD];
 }
 
 auto
-bao::Parser :: current() -> bao::Token {
-    return this->tokens[this->it];
+bao::Parser :: current_value() -> std::string_view {
+    return this->lexer ? this->lexer->text(this->current()) : this->tokens->text(this->current());
+}
+
+auto
+bao::Parser :: current_symbol() -> bao::Symbol {
+    // The lexer interned identifiers already, other tokens used as names are interned here
+    if (this->current().type == TokenType::Identifier) {
+        return static_cast<Symbol>(this->current().id);
+    }
+    return Interner::global().intern(this->current_value());
+}
+
+auto
+bao::Parser :: current_line() -> int {
+    return static_cast<int>(this->current().line);
+}
+
+auto
+bao::Parser :: current_column() -> int {
+    const Token& token = this->current();
+    // Tokens are asked for in order, so a long line is scanned once instead of from its start every time
+    if (token.line == this->column_line && token.offset >= this->column_offset) {
+        this->column_value = this->lexer
+            ? this->lexer->column(token, this->column_offset, this->column_value)
+            : this->tokens->column(token, this->column_offset, this->column_value);
+    } else {
+        this->column_value = this->lexer ? this->lexer->column(token) : this->tokens->column(token);
+        this->column_line = token.line;
+    }
+    this->column_offset = token.offset;
+    return this->column_value;
+}
+
+// An error quoting its line from the source that was lexed, not from the file on disk
+auto
+bao::Parser :: error(const string &message, const int line, const int column) const -> bao::utils::CompilerError {
+    return utils::CompilerError::new_error(this->lexer ? this->lexer->get_lexed() : *this->tokens, message, line, column);
 }
 
 // --- Helpers ---
 
+// Move to a token of the list, dropping the lookahead
+void
+bao::Parser :: seek(const size_t index) {
+    this->position = index;
+    this->pulled = this->head + 1;
+    this->window[this->head % LOOKAHEAD] = this->pull();
+}
+
+auto
+bao::Parser :: pull() -> bao::Token {
+    if (this->lexer) {
+        return this->lexer->next_token();
+    }
+    if (this->position < this->end) {
+        return (*this->tokens)[this->position++];
+    }
+    // A part ends where the next one starts, as if the source ended there
+    const Token& following = (*this->tokens)[this->end];
+    return {TokenType::EndOfFile, 0, following.offset, following.line, 0};
+}
+
 void
 bao::Parser :: next() {
-    this->it++;
-    if (this->it == this->tokens.size()) {
+    if (this->current().type == TokenType::EndOfFile) {
         throw out_of_range("Lỗi nội bộ: Không còn token");
     }
+    this->head++;
+    if (this->head == this->pulled) {
+        this->window[this->pulled++ % LOOKAHEAD] = this->pull();
+    }
 }
 
 auto
-bao::Parser :: peek() -> bao::Token {
-    if (this->tokens[this->it].type == TokenType::EndOfFile) {
+bao::Parser :: peek() -> const bao::Token& {
+    if (this->current().type == TokenType::EndOfFile) {
         throw out_of_range("Lỗi nội bộ: Không còn token để hé lộ");
     }
-    return this->tokens[this->it + 1];
+    if (this->head + 1 == this->pulled) {
+        this->window[this->pulled++ % LOOKAHEAD] = this->pull();
+    }
+    return this->window[(this->head + 1) % LOOKAHEAD];
 }
 
 void
@@ -264,85 +509,56 @@ bao::Parser :: skip_newlines() {
 
 auto
 bao::Parser :: current_precedence() -> int {
-    bao::Token current = this->current();
-    if (current.type == bao::TokenType::Operator || current.type == bao::TokenType::Keyword) {
-        if (precedences.contains(current.value)) {
-            return precedences.at(current.value);
-        }
-    }
-    return -1;
+    return binary_of(this->current()).precedence;
 }
 
 
 // --- Statements ---
 
 auto
-bao::Parser :: parse_statement() -> std::unique_ptr<bao::ast::StmtNode> {
-    std::unique_ptr<ast::StmtNode> stmt;
-    try {
-        utils::match(this->current().value,{
-            {
-                "trả về", [&]() {
-                    try {
-                        stmt = this->parse_retstmt();
-                    } catch ([[maybe_unused]] exception& e) {
-                        throw utils::CompilerError::new_error(
-                            this->filename, this->directory, "Lỗi cú pháp trong câu lệnh trả về", this->current().line, this->current().column
-                        );
-                    }
-                }
-            },
-            {
-                "biến", [&]() {
-                    try {
-                        stmt = this->parse_vardeclstmt(false);
-                    } catch (...) {
-                        throw;
-                    }
-                }
-            }, {
-                "hằng", [&]() {
-                    try {
-                        stmt = this->parse_vardeclstmt(true);
-                    } catch (...) {
-                        throw;
-                    }
+bao::Parser :: parse_statement() -> bao::ast::StmtNode* {
+    // "biến" and "hằng" are not keywords, they are told apart by their symbols
+    static const Symbol var_symbol = Interner::global().intern("biến");
+    static const Symbol const_symbol = Interner::global().intern("hằng");
+    ast::StmtNode* stmt;
+    switch (this->current().type) {
+        case TokenType::Keyword:
+            if (this->current().is(Keyword::Return)) {
+                try {
+                    stmt = this->parse_retstmt();
+                } catch ([[maybe_unused]] exception& e) {
+                    throw this->error("Lỗi cú pháp trong câu lệnh trả về", this->current_line(), this->current_column());
                 }
+                break;
             }
-        }, {
-            [&]() {
-                    if (this->current().type == TokenType::Identifier) {
-                        try {
-                            stmt = this->parse_varassignstmt();
-                        } catch (...) {
-                            throw;
-                        }
-                    } else {
-                        throw utils::CompilerError::new_error(
-                            this->filename, this->directory, "Câu lệnh không xác định", this->current().line, this->current().column
-                        );
-                    }
-                }
+            throw this->error("Câu lệnh không xác định", this->current_line(), this->current_column());
+        case TokenType::Identifier:
+            if (const auto symbol = static_cast<Symbol>(this->current().id); symbol == var_symbol) {
+                stmt = this->parse_vardeclstmt(false);
+            } else if (symbol == const_symbol) {
+                stmt = this->parse_vardeclstmt(true);
+            } else {
+                stmt = this->parse_varassignstmt();
             }
-        );
-    } catch ([[maybe_unused]] exception& e) {
-        throw;
+            break;
+        default:
+            throw this->error("Câu lệnh không xác định", this->current_line(), this->current_column());
     }
     return stmt;
 }
 
 auto
-bao::Parser :: parse_retstmt() -> std::unique_ptr<bao::ast::RetStmt> {
-    auto line = this->current().line;
-    auto column = this->current().column;
+bao::Parser :: parse_retstmt() -> bao::ast::RetStmt* {
+    auto line = this->current_line();
+    auto column = this->current_column();
     this->next(); // Consumes 'trả về'
     if (this->current().type == TokenType::Newline || this->current().type == TokenType::Semicolon) {
         this->next(); // Consumes '\n' or ';'
-        return std::make_unique<ast::RetStmt>(nullptr, line, column);
+        return this->arena.make<ast::RetStmt>(nullptr, line, column);
     }
     try {
-        std::unique_ptr<ast::ExprNode> expr = this->parse_expression(0);
-        return std::make_unique<ast::RetStmt>(std::move(expr), line, column);
+        ast::ExprNode* expr = this->parse_expression(0);
+        return this->arena.make<ast::RetStmt>(expr, line, column);
     } catch ([[maybe_unused]] exception& e) {
         throw;
     }
@@ -351,34 +567,27 @@ bao::Parser :: parse_retstmt() -> std::unique_ptr<bao::ast::RetStmt> {
 auto
 bao::Parser :: parse_vardeclstmt(
     bool isConst
-) -> std::unique_ptr<bao::ast::VarDeclStmt> {
-    auto line = this->current().line;
-    auto column = this->current().column;
+) -> bao::ast::VarDeclStmt* {
+    auto line = this->current_line();
+    auto column = this->current_column();
     this->next(); // Consumes 'hằng' or 'biến'
     if (this->current().type != TokenType::Identifier) {
-        throw utils::CompilerError::new_error(
-            this->filename, this->directory, 
-            "Mong đợi tên biến tại đây", 
-            this->current().line, this->current().column
-        );
+        throw this->error("Mong đợi tên biến tại đây", this->current_line(), this->current_column());
     }
     try {
         auto varNode = this->parse_var(isConst);
-        std::unique_ptr<bao::ast::ExprNode> val = nullptr;
-        if (current().value == ":=") {
+        bao::ast::ExprNode* val = nullptr;
+        if (this->current().is(Operator::Assign)) {
             this->next(); // Consumes ':=' token
             val = this->parse_expression(0);
         } else if (isConst) {
-            auto temp_line = this->current().line;
-            auto temp_column = this->current().column;
-            throw utils::CompilerError::new_error(
-                this->filename, this->directory,
-                "Hằng số phải có giá trị khởi tạo", 
-                temp_line, temp_column);
+            auto temp_line = this->current_line();
+            auto temp_column = this->current_column();
+            throw this->error("Hằng số phải có giá trị khởi tạo", temp_line, temp_column);
         }
-        return std::make_unique<ast::VarDeclStmt>(
+        return this->arena.make<ast::VarDeclStmt>(
             varNode, 
-            std::move(val), 
+            val, 
             line, column
         );
     } catch ([[maybe_unused]] exception& e) {
@@ -387,22 +596,19 @@ bao::Parser :: parse_vardeclstmt(
 }
 
 auto
-bao::Parser :: parse_varassignstmt() -> std::unique_ptr<bao::ast::VarAssignStmt> {
-    auto line = this->current().line;
-    auto column = this->current().column;
-    std::string var_name = this->current().value;
+bao::Parser :: parse_varassignstmt() -> bao::ast::VarAssignStmt* {
+    auto line = this->current_line();
+    auto column = this->current_column();
+    const std::string_view var_name = this->arena.copy(this->current_value());
+    const Symbol var_symbol = this->current_symbol();
     this->next();
 
-    if (this->current().value != ":=") {
-        throw utils::CompilerError::new_error(
-            this->filename, this->directory, 
-            "Mong đợi ':=' tại đây",
-            this->current().line, this->current().column
-        );
+    if (!this->current().is(Operator::Assign)) {
+        throw this->error("Mong đợi ':=' tại đây", this->current_line(), this->current_column());
     }
     this->next();
 
-    std::unique_ptr<ast::ExprNode> val;
+    ast::ExprNode* val;
     try {
         val = this->parse_expression(0);
     } catch (...) {
@@ -410,13 +616,14 @@ bao::Parser :: parse_varassignstmt() -> std::unique_ptr<bao::ast::VarAssignStmt>
     }
     auto var = ast::VarNode(
             var_name,
-            std::make_unique<UnknownType>(),
+            var_symbol,
+            TypeContext::builtins().unknown(),
             false,
             line, column
         );
-    return std::make_unique<ast::VarAssignStmt>(
+    return this->arena.make<ast::VarAssignStmt>(
         var,
-        std::move(val),
+        val,
         line, column
     );
 }
@@ -425,114 +632,131 @@ auto
 bao::Parser :: parse_var(
     bool isConst
 ) -> bao::ast::VarNode  {
-    auto var_line = this->current().line;
-    auto var_column = this->current().column;
-    std::string var_name = this->current().value;
+    auto var_line = this->current_line();
+    auto var_column = this->current_column();
+    const std::string_view var_name = this->arena.copy(this->current_value());
+    const Symbol var_symbol = this->current_symbol();
     this->next();
-    if (this->current().value != "E") {
-        throw utils::CompilerError::new_error(
-            this->filename, this->directory, "Mong đợi ký hiệu 'E' tại đây", this->current().line, this->current().column
-        );
+    if (!this->current().is(Operator::Of)) {
+        throw this->error("Mong đợi ký hiệu 'E' tại đây", this->current_line(), this->current_column());
     }
     this->next();
     try {
-        auto type = this->parse_type();
-        return ast::VarNode(var_name, std::move(type), isConst, var_line, var_column);
+        const Type* type = this->parse_type();
+        return ast::VarNode(var_name, var_symbol, type, isConst, var_line, var_column);
     } catch ([[maybe_unused]] exception& e) {
         throw;
     }
 }
 
 auto
-bao::Parser :: parse_type() -> std::unique_ptr<bao::Type> {
+bao::Parser :: parse_type() -> const bao::Type* {
     if (this->current().type != TokenType::Identifier) {
-        throw utils::CompilerError::new_error(
-        this->filename, this->directory, "Kiểu dữ liệu không xác định", this->current().line, this->current().column
-        );
+        throw this->error("Kiểu dữ liệu không xác định", this->current_line(), this->current_column());
     }
     
     // TODO: Implement types other than primitive
-    if (!primitive_map.contains(this->current().value)) {
-        throw utils::CompilerError::new_error(
-            this->filename, this->directory, "Mong đợi kiểu nguyên thuỷ", this->current().line, this->current().column);
+    const Type* type = TypeContext::builtins().primitive(this->current_value());
+    if (!type) {
+        throw this->error("Mong đợi kiểu nguyên thuỷ", this->current_line(), this->current_column());
     }
-    std::string type_name = this->current().value;
     this->next();
-    return std::make_unique<PrimitiveType>(type_name);
+    return type;
 }
 
 auto
 bao::Parser :: parse_expression(
-    int minPrec
-) -> std::unique_ptr<bao::ast::ExprNode> {
-    try {
-        // Expression's position
-        auto line = this->current().line;
-        auto column = this->current().column;
-
-        // Parse the left-hand side
-        auto left = this->parse_primary();
+    const int minPrec
+) -> bao::ast::ExprNode* {
+    // Precedence climbing with a stack of levels instead of recursion, so long and
+    // deeply nested expressions cannot overflow the native stack. A level gathers
+    // the operators binding at least as tight as its minimum precedence
+    struct Level {
+        int min_prec;
+        int line; // Position of the level's first operand, shared by its binary expressions
+        int column;
+        bool paren; // Whether ')' closes the level
+        ast::ExprNode* left;
+        ast::BinOp op;
+    };
+    vector<Level> levels;
+    levels.push_back({minPrec, this->current_line(), this->current_column(), false, nullptr, ast::BinOp::Or});
+    size_t depth = 0; // Parentheses open
+
+    while (true) {
+        if (this->current().type == TokenType::LParen) {
+            if (depth == this->max_nesting) {
+                const int line = this->current_line();
+                const int column = this->current_column();
+                // One error for the expression, not one for every token left of it
+                while (this->current().type != TokenType::Newline && this->current().type != TokenType::EndOfFile) {
+                    this->next();
+                }
+                throw this->error(std::format("Biểu thức lồng nhau quá sâu, tối đa {} cấp ngoặc", this->max_nesting), line, column);
+            }
+            this->next(); // Consumes '('
+            depth++;
+            levels.push_back({0, this->current_line(), this->current_column(), true, nullptr, ast::BinOp::Or});
+            continue;
+        }
 
-        // Funny loop
-        while(true) {
-            int prec = this->current_precedence();
-            if (prec < minPrec) {
+        // Fold the operand into its level, and close the levels it ends
+        ast::ExprNode* operand = this->parse_primary();
+        while (true) {
+            Level& level = levels.back();
+            level.left = level.left
+                ? this->arena.make<ast::BinExpr>(
+                    level.left, level.op, operand, TypeContext::builtins().unknown(), level.line, level.column)
+                : operand;
+            if (const int prec = this->current_precedence(); prec >= level.min_prec) {
+                // The right-hand side binds tighter, which keeps operators left-associative
+                level.op = binary_of(this->current()).op;
+                this->next(); // Consumes the operator
+                levels.push_back({prec + 1, this->current_line(), this->current_column(), false, nullptr, ast::BinOp::Or});
                 break;
             }
-
-            const auto current = this->current();
-            auto op = current.value; // Binary operator
-            this->next(); // Consumes token
-
-            // Parse right-hand side expression with higher precedence for right-associativity
-            auto right = this->parse_expression(prec + 1);
-
-            left = std::make_unique<ast::BinExpr>(std::move(left), std::move(op), std::move(right), line, column);
+            operand = level.left;
+            const bool paren = level.paren;
+            levels.pop_back();
+            if (paren) {
+                if (this->current().type != TokenType::RParen) {
+                    throw this->error("Mong đợi ')' tại đây", this->current_line(), this->current_column());
+                }
+                this->next(); // Consumes ')'
+                depth--;
+            }
+            if (levels.empty()) {
+                return operand;
+            }
         }
-
-        return std::move(left);
-    } catch ([[maybe_unused]] exception& e) {
-        throw;
     }
 }
 
 auto
-bao::Parser :: parse_primary() -> std::unique_ptr<bao::ast::ExprNode>  {
+bao::Parser :: parse_primary() -> bao::ast::ExprNode*  {
     const auto current = this->current();
-    const auto val = current.value;
-    auto line = this->current().line;
-    auto column = this->current().column;
+    const std::string_view val = this->arena.copy(this->current_value());
+    const Symbol symbol = current.type == TokenType::Identifier ? static_cast<Symbol>(current.id) : Interner::NONE;
+    auto line = this->current_line();
+    auto column = this->current_column();
     this->next(); // Consumes token
     switch (current.type) {
         case TokenType::Identifier:
-            return std::make_unique<ast::VarExpr>(
-                val, std::make_unique<UnknownType>(),
+            return this->arena.make<ast::VarExpr>(
+                val, symbol, TypeContext::builtins().unknown(),
                 line, column
             );
         case TokenType::Literal:
             if (val.contains(".")) {
-                return std::make_unique<ast::NumLitExpr>(
-                    val, std::make_unique<PrimitiveType>("R64"),
+                return this->arena.make<ast::NumLitExpr>(
+                    val, TypeContext::builtins().primitive(Primitive::R64),
                     line, column);
             }
-            return std::make_unique<ast::NumLitExpr>(
-                val, std::make_unique<PrimitiveType>("Z64"),
+            return this->arena.make<ast::NumLitExpr>(
+                val, TypeContext::builtins().primitive(Primitive::Z64),
                 line, column);
 
-        case TokenType::LParen: {
-            auto expr = this->parse_expression(0);
-            if (this->current().type != TokenType::RParen) {
-                throw utils::CompilerError::new_error(
-                    this->filename, this->directory,
-                    "Mong đợi ')' tại đây", this->current().line, this->current().column);
-            }
-            this->next();
-            return std::move(expr);
-        }
         default:
-            throw utils::CompilerError::new_error(
-                this->filename, this->directory,
-                "Biểu thức không xác định",
-                this->current().line, this->current().column);
+            throw this->error("Biểu thức không xác định", this->current_line(), this->current_column());
     }
 }
\ No newline at end of file
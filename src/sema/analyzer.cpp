@@ -6,8 +6,15 @@
 #include "bao/sema/symtabl.h"
 #include "bao/utils.h"
 #include <bao/sema/analyzer.h>
+#include <bao/parallel.h>
+#include <algorithm>
 #include <exception>
 
+namespace {
+    // Below this many functions the threads cost more than they save
+    constexpr size_t PARALLEL_ANALYSIS_THRESHOLD = 256;
+}
+
 bao::Analyzer :: Analyzer(
     ast::Program &&program
 ) : program(std::move(program)) {
@@ -16,6 +23,13 @@ bao::Analyzer :: Analyzer(
 
 auto
 bao::Analyzer :: analyze_program() -> bao::ast::Program {
+    return this->analyze_program_parallel(1);
+}
+
+auto
+bao::Analyzer :: analyze_program_parallel(
+    const unsigned threads
+) -> bao::ast::Program {
     // Forward declaration of functions
     for (auto& func : program.funcs) {
         // Insert the function into the symbol table
@@ -23,16 +37,42 @@ bao::Analyzer :: analyze_program() -> bao::ast::Program {
             sema::SymbolType::Function,
             func.get_return_type()
         };
-        this->symbolTable.insert(func.get_name(), info);
+        this->symbolTable.insert(func.get_symbol(), info);
     }
 
-    // Iterate through all functions in the program
+    // Bodies the parser skimmed over are parsed now, throwing the errors it would have
+    program.force_bodies();
+
+    // Functions only read the global scope, each run of them resolves names
+    // in a copy of it and opens its own scopes on top
+    const size_t count = program.funcs.size();
+    std::vector<exception_ptr> errors(count);
+    const size_t runs = threads < 2 || count < PARALLEL_ANALYSIS_THRESHOLD
+                            ? 1
+                            : std::min<size_t>(count, static_cast<size_t>(threads) * 4);
+    auto analyze_run = [&](sema::SymbolTable& table, const size_t run) {
+        for (size_t i = count * run / runs; i < count * (run + 1) / runs; i++) {
+            try {
+                analyze_function(table, program.funcs[i]);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+    if (runs == 1) {
+        analyze_run(this->symbolTable, 0);
+    } else {
+        parallel::for_each(runs, [&](const size_t run) {
+            sema::SymbolTable table = this->symbolTable;
+            analyze_run(table, run);
+        }, threads);
+    }
+
+    // Reported in source order, whichever thread met them
     std::vector<exception_ptr> exceptions;
-    for (auto& func : program.funcs) {
-        try {
-            analyze_function(func);
-        } catch (...) {
-            exceptions.emplace_back(std::current_exception());
+    for (const exception_ptr& error : errors) {
+        if (error) {
+            exceptions.push_back(error);
         }
     }
     if (!exceptions.empty()) {
@@ -47,22 +87,24 @@ bao::Analyzer :: analyze_program() -> bao::ast::Program {
 
 void 
 bao::Analyzer :: analyze_function(
+    sema::SymbolTable &table,
     const ast::FuncNode &func
 ) {
-    sema::SymbolTable localTable(&this->symbolTable);
+    // The function's scope, declarations in it shadow the functions
+    sema::SymbolTable::Scope scope(table);
     // Insert param into the local symbol table
     for (auto& param : func.get_params()) {
         // Insert the parameter into the local symbol table
         sema::SymbolInfo info{};
         info.type = sema::SymbolType::Variable;
         info.datatype = param.get_type();
-        localTable.insert(param.get_name(), info);
+        table.insert(param.get_symbol(), info);
     }
 
     std::vector<exception_ptr> exceptions;
-    for (auto& stmt : func.get_stmts()) {
+    for (ast::StmtNode* stmt : func.get_stmts()) {
         try {
-            analyze_statement(localTable, stmt.get(), func.get_return_type());
+            analyze_statement(table, stmt, func.get_return_type());
         } catch (...) {
             exceptions.emplace_back(std::current_exception());
         }
@@ -85,30 +127,41 @@ void
 bao::Analyzer :: analyze_statement(
     sema::SymbolTable &parentTable, 
     ast::StmtNode* stmt, 
-    Type* return_type
+    const Type* return_type
 ) {
-    if (auto retStmt = dynamic_cast<ast::RetStmt*>(stmt)) {
-        try {
-            this->analyze_retstmt(parentTable, retStmt, return_type);
-        } catch (...) {
-            throw;
+    switch (stmt->get_kind()) {
+        case ast::NodeKind::RetStmt: {
+            auto retStmt = cast<ast::RetStmt>(stmt);
+            try {
+                this->analyze_retstmt(parentTable, retStmt, return_type);
+            } catch (...) {
+                throw;
+            }
+            break;
         }
-    } else if (auto varDeclStmt = dynamic_cast<ast::VarDeclStmt*>(stmt)) {
-        try {
-            this->analyze_vardeclstmt(parentTable, varDeclStmt);
-        } catch (...) {
-            throw;
+        case ast::NodeKind::VarDeclStmt: {
+            auto varDeclStmt = cast<ast::VarDeclStmt>(stmt);
+            try {
+                this->analyze_vardeclstmt(parentTable, varDeclStmt);
+            } catch (...) {
+                throw;
+            }
+            break;
         }
-    } else if (auto varAssignStmt = dynamic_cast<ast::VarAssignStmt*>(stmt)) {
-        try {
-            this->analyze_varassignstmt(parentTable, varAssignStmt);
-        } catch (...) {
-            throw;
+        case ast::NodeKind::VarAssignStmt: {
+            auto varAssignStmt = cast<ast::VarAssignStmt>(stmt);
+            try {
+                this->analyze_varassignstmt(parentTable, varAssignStmt);
+            } catch (...) {
+                throw;
+            }
+            break;
+        }
+        default: {
+            // Handle other statement types
+            auto [line, column] = stmt->pos();
+            throw utils::CompilerError::new_error(program.name, program.path, "Câu lệnh không xác định", line, column);
         }
-    } else {
-        // Handle other statement types
-        auto [line, column] = stmt->pos();
-        throw utils::CompilerError::new_error(program.name, program.path, "Câu lệnh không xác định", line, column);
     }
 }
 
@@ -116,7 +169,7 @@ void
 bao::Analyzer :: analyze_retstmt(
     bao::sema::SymbolTable& parentTable, 
     bao::ast::RetStmt* stmt, 
-    Type* return_type
+    const Type* return_type
 ) {
     // Analyze return statement
     if (stmt->get_val()) {
@@ -127,7 +180,7 @@ bao::Analyzer :: analyze_retstmt(
         }
     }
     // Check if the return type matches the function's return type
-    if (return_type->get_name() != "rỗng") {
+    if (return_type != TypeContext::builtins().primitive(Primitive::Void)) {
         // Check if the return type matches the function's return type
         if (!stmt->get_val()) return;
         try {
@@ -151,7 +204,7 @@ bao::Analyzer :: analyze_vardeclstmt(
     bao::ast::VarDeclStmt* stmt
 ) {
     if (!parentTable.insert(
-        stmt->get_var().get_name(), 
+        stmt->get_var().get_symbol(),
         {
             sema::SymbolType::Variable,
             stmt->get_var().get_type(),
@@ -191,7 +244,7 @@ bao::Analyzer :: analyze_varassignstmt(
 ) {
     auto symbol = 
         parentTable.lookup(
-            stmt->get_var().get_name()
+            stmt->get_var().get_symbol()
         );
     if (!symbol || symbol->type != sema::SymbolType::Variable) {
         auto [line, column] = stmt->pos();
@@ -203,7 +256,7 @@ bao::Analyzer :: analyze_varassignstmt(
     }
 
     // Resolve type
-    stmt->get_var().set_type(symbol->datatype->clone());
+    stmt->get_var().set_type(symbol->datatype);
 
     // Constants cannot be reassigned
     if (symbol->isConst) {
@@ -239,111 +292,173 @@ bao::Analyzer :: analyze_expression(
     sema::SymbolTable &parentTable, 
     ast::ExprNode* expr
 ) {
-    if (dynamic_cast<ast::NumLitExpr*>(expr)) {
-        // Analyze number literal expression
-        // No action needed for number literals
-    } else if (auto var = dynamic_cast<ast::VarExpr*>(expr)) {
-        auto symbol = parentTable.lookup(var->get_name());
-        if (!symbol || symbol->type != sema::SymbolType::Variable) {
-            auto [line, column] = var->pos();
-            throw utils::CompilerError::new_error(
-                this->program.name, this->program.path,
-                "Biến không xác định, chưa khai báo hoặc trùng tên với hàm", 
-                line, column
-            );
+    // Post-order walk over explicit stacks, generated expressions can nest far deeper
+    // than the native stack allows. Each node hands its parent its errors, null when
+    // there are none, and whether it is made of literals only
+    struct Result {
+        std::exception_ptr error;
+        bool literal;
+    };
+    std::vector<std::pair<ast::ExprNode*, bool>> pending{{expr, false}}; // Node, whether its operands are done
+    std::vector<Result> results;
+    while (!pending.empty()) {
+        const auto [node, operands_done] = pending.back();
+        pending.pop_back();
+        if (node->get_kind() != ast::NodeKind::BinExpr) {
+            Result result{nullptr, node->get_kind() == ast::NodeKind::NumLitExpr};
+            try {
+                this->analyze_operand(parentTable, node);
+            } catch (...) {
+                result.error = std::current_exception();
+            }
+            results.push_back(result);
+            continue;
         }
-        var->set_type(symbol->datatype->clone());
-    } else if (auto bin_expr = dynamic_cast<ast::BinExpr*>(expr)) {
-        auto left = bin_expr->get_left();
-        auto right = bin_expr->get_right();
+        const auto bin_expr = cast<ast::BinExpr>(node);
+        if (!operands_done) {
+            // The left operand is analyzed first
+            pending.emplace_back(node, true);
+            pending.emplace_back(bin_expr->get_right(), false);
+            pending.emplace_back(bin_expr->get_left(), false);
+            continue;
+        }
+        const Result right = results.back();
+        results.pop_back();
+        const Result left = results.back();
+        results.pop_back();
 
-        // Resolve left and right's type if they're binary expressions (Unknown by default)
+        // Resolve left and right's type first, their errors stop the check of this node
+        Result result{nullptr, left.literal && right.literal};
         std::vector<std::exception_ptr> exceptions;
-
-        try {
-            analyze_expression(parentTable, left);
-        } catch (...) {
-            exceptions.push_back(std::current_exception());
+        if (left.error) {
+            exceptions.push_back(left.error);
         }
-        try {
-            analyze_expression(parentTable, right);
-        } catch (...) {
-            exceptions.push_back(std::current_exception());
+        if (right.error) {
+            exceptions.push_back(right.error);
         }
         if (!exceptions.empty()) {
-            throw bao::utils::ErrorList(exceptions);
+            result.error = std::make_exception_ptr(bao::utils::ErrorList(exceptions));
+        } else {
+            try {
+                this->analyze_binary(bin_expr, left.literal, right.literal);
+            } catch (...) {
+                result.error = std::current_exception();
+            }
         }
+        results.push_back(result);
+    }
+    if (results.back().error) {
+        std::rethrow_exception(results.back().error);
+    }
+}
 
-        // TODO: Implement proper type checking later
-        if (left->get_type()->get_name() == right->get_type()->get_name()) {
-            expr->set_type(left->get_type()->clone());
-            return;
+void
+bao::Analyzer :: analyze_operand(
+    sema::SymbolTable &parentTable,
+    ast::ExprNode* expr
+) {
+    switch (expr->get_kind()) {
+        case ast::NodeKind::NumLitExpr: {
+            // Analyze number literal expression
+            // No action needed for number literals
+            break;
         }
-
-        // Check if can literal cast
-        auto [lline, lcolumn] = left->pos();
-        auto [rline, rcolumn] = right->pos();
-        if (!utils::is_literal(left) && !utils::is_literal(right)) {
-            auto [line, column] = left->pos();
-            throw utils::CompilerError::new_error(
-                program.name, program.path, 
-                std::format("Kiểu dữ liệu của hai biểu thức khác nhau {} {} {}",
-                                    left->get_type()->get_name(),
-                                    bin_expr->get_op(),
-                                    right->get_type()->get_name()),
-                lline, lcolumn, rcolumn - lcolumn);
+        case ast::NodeKind::VarExpr: {
+            auto var = cast<ast::VarExpr>(expr);
+            auto symbol = parentTable.lookup(var->get_symbol());
+            if (!symbol || symbol->type != sema::SymbolType::Variable) {
+                auto [line, column] = var->pos();
+                throw utils::CompilerError::new_error(
+                    this->program.name, this->program.path,
+                    "Biến không xác định, chưa khai báo hoặc trùng tên với hàm", 
+                    line, column
+                );
+            }
+            var->set_type(symbol->datatype);
+            break;
+        }
+        default: {
+            // Handle other expression types
+            throw std::runtime_error("Kiểu biểu thức không hỗ trợ");
         }
+    }
+}
 
-        // Left is a number literal
-        if (utils::is_literal(left) && !utils::is_literal(right)) {
-            auto num_left = dynamic_cast<ast::NumLitExpr*>(left);
-            if (utils::can_cast_literal(num_left, right->get_type())) {
-                try {
-                    utils::cast_literal(num_left, right->get_type());
-                    expr->set_type(right->get_type()->clone());
-                    return;
-                } catch ([[maybe_unused]] exception& e) {
-                    throw;
-                }
+void
+bao::Analyzer :: analyze_binary(
+    ast::BinExpr* expr,
+    const bool left_literal,
+    const bool right_literal
+) {
+    auto left = expr->get_left();
+    auto right = expr->get_right();
+
+    // TODO: Implement proper type checking later
+    if (left->get_type() == right->get_type()) {
+        expr->set_type(left->get_type());
+        return;
+    }
+
+    // Check if can literal cast
+    auto [lline, lcolumn] = left->pos();
+    auto [rline, rcolumn] = right->pos();
+    if (!left_literal && !right_literal) {
+        auto [line, column] = left->pos();
+        throw utils::CompilerError::new_error(
+            program.name, program.path, 
+            std::format("Kiểu dữ liệu của hai biểu thức khác nhau {} {} {}",
+                                left->get_type()->get_name(),
+                                ast::bin_op_text(expr->get_op()),
+                                right->get_type()->get_name()),
+            lline, lcolumn, rcolumn - lcolumn);
+    }
+
+    // Left is a number literal
+    if (left_literal && !right_literal) {
+        auto num_left = dyn_cast<ast::NumLitExpr>(left);
+        if (utils::can_cast_literal(num_left, right->get_type())) {
+            try {
+                utils::cast_literal(num_left, right->get_type());
+                expr->set_type(right->get_type());
+                return;
+            } catch ([[maybe_unused]] exception& e) {
+                throw;
             }
         }
-        
-        // Right is a number literal
-        if (utils::is_literal(right) && !utils::is_literal(left)) {
-            auto num_right = dynamic_cast<ast::NumLitExpr*>(right);
-            if (utils::can_cast_literal(num_right, left->get_type())) {
-                try {
-                    utils::cast_literal(num_right, left->get_type());
-                    expr->set_type(left->get_type()->clone());
-                    return;
-                } catch ([[maybe_unused]] exception& e) {
-                    throw;
-                }
+    }
+
+    // Right is a number literal
+    if (right_literal && !left_literal) {
+        auto num_right = dyn_cast<ast::NumLitExpr>(right);
+        if (utils::can_cast_literal(num_right, left->get_type())) {
+            try {
+                utils::cast_literal(num_right, left->get_type());
+                expr->set_type(left->get_type());
+                return;
+            } catch ([[maybe_unused]] exception& e) {
+                throw;
             }
         }
-        
-        // Fallback
-        throw utils::CompilerError::new_error(
-            program.name, 
-            program.path, 
-            std::format("Kiểu dữ liệu của hai biểu thức khác nhau: {} {} {}",
-                                    left->get_type()->get_name(),
-                                    bin_expr->get_op(),
-                                    right->get_type()->get_name()),
-            lline, lcolumn, rcolumn - lcolumn);
-    } else {
-        // Handle other expression types
-        throw std::runtime_error("Kiểu biểu thức không hỗ trợ");
     }
+
+    // Fallback
+    throw utils::CompilerError::new_error(
+        program.name, 
+        program.path, 
+        std::format("Kiểu dữ liệu của hai biểu thức khác nhau: {} {} {}",
+                                left->get_type()->get_name(),
+                                ast::bin_op_text(expr->get_op()),
+                                right->get_type()->get_name()),
+        lline, lcolumn, rcolumn - lcolumn);
 }
 
 void 
 bao::Analyzer :: analyze_type(
     ast::ExprNode* val, 
-    Type* type
+    const Type* type
 ) {
-    // TODO: For now check only the type name, check it better later
-    if (val->get_type()->get_name() == type->get_name()) {
+    // Types are unique, equal types are the same object
+    if (val->get_type() == type) {
         return;
     }
 
@@ -8,7 +8,15 @@
 #include <iostream>
 #include <string>
 #include <filesystem>
+#include <fstream>
 #include <regex>
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
 
 #include <unicode/unistr.h>
 #include <unicode/normalizer2.h>
@@ -16,10 +24,15 @@
 #include <unicode/schriter.h>
 
 #include <bao/filereader/reader.h>
+#include <bao/filereader/manager.h>
+#include <bao/filereader/utf8.h>
+#include <bao/interner.h>
 #include <bao/utils.h>
 #include <bao/lexer/lexer.h>
 #include <bao/parser/parser.h>
+#include <bao/parser/cache.h>
 #include <bao/sema/analyzer.h>
+#include <bao/sema/symtabl.h>
 #include <bao/mir/translator.h>
 
 #include <llvm/IR/LLVMContext.h>
@@ -40,12 +53,49 @@ using icu::StringCharacterIterator;
 
 // --- Test functions ---
 
-void compilerTest();
+void compilerTest(const string& cache_directory);
 void mirTest();
 void semanticsTest();
 void parserTest();
+void operatorTest();
+void diagnosticTest();
+void parallelTest();
+void lazyBodyTest();
 void lexerTest();
 void readerTest();
+void utf8Benchmark();
+void lexerBenchmark();
+void keywordBenchmark();
+void relexBenchmark();
+void commentBenchmark();
+void internerBenchmark();
+void semanticsBenchmark();
+void analyzerBenchmark();
+void parserBenchmark();
+void expressionBenchmark();
+void cacheBenchmark();
+void symbolTableBenchmark();
+string write_source(const string& name, const string& text);
+string generated_program(int functions);
+string dump_program(const bao::ast::Program& program);
+
+// Threads the parallel paths are checked with, whatever the machine has
+constexpr unsigned CHECK_THREADS = 4;
+
+/**
+ * Runs a stage sequentially and on CHECK_THREADS threads
+ * @param run Runs the stage on a number of threads, one meaning sequentially
+ * @return What the sequential run gave, nothing when the parallel run gave something else
+ */
+template<typename Run>
+auto on_threads(Run&& run) -> std::optional<decltype(run(1u))> {
+    auto sequential = run(1u);
+    if (sequential != run(CHECK_THREADS)) {
+        return std::nullopt;
+    }
+    return sequential;
+}
+
 /*
 * Test from bottom up
 */
@@ -55,7 +105,28 @@ void llvmTest();
 
 // Main test function
 int test(int argc, char* argv[]) {
-    compilerTest();
+    if (bao::utils::arg_contains(argc, argv, "--bench")) {
+        utf8Benchmark();
+        lexerBenchmark();
+        keywordBenchmark();
+        relexBenchmark();
+        commentBenchmark();
+        internerBenchmark();
+        semanticsBenchmark();
+        analyzerBenchmark();
+        parserBenchmark();
+        expressionBenchmark();
+        cacheBenchmark();
+        symbolTableBenchmark();
+        return 0;
+    }
+    // Parsed programs are kept next to the sources unless told otherwise
+    const char* cache_directory = bao::utils::arg_value(argc, argv, "--bo-nho-dem");
+    compilerTest(cache_directory ? cache_directory : "test/.bao_cache");
+    operatorTest();
+    diagnosticTest();
+    parallelTest();
+    lazyBodyTest();
     return 0;
 }
 
@@ -63,24 +134,40 @@ void linuxStartTest() {
     bao::utils::generate_start();
 }
 
-void compilerTest() {
+void compilerTest(const string& cache_directory) {
     try {
-        const bao::Reader reader("test/test.bao");
-        const string source = reader.read();
+        bao::SourceManager& sources = bao::SourceManager::global();
+        const bao::FileId file_id = sources.load("test/test.bao");
+        const std::string_view source = sources.get_buffer(file_id);
         cout << "Nội dung tệp nguồn:" << endl;
         cout << source << endl;
 
         cout << "Đang phân loại ký hiệu..." << endl;
-        bao::Lexer lexer(source);
+        bao::Lexer lexer(source, sources.is_validated(file_id));
         lexer.tokenize();
-        vector<bao::Token> tokens = lexer.get_tokens();
+        const bao::TokenList& tokens = lexer.get_tokens();
         for (const auto& token : tokens) {
-            bao::utils::print_token(token);
+            bao::utils::print_token(tokens, token);
         }
 
         cout << "\033[33mĐang phân tích cú pháp...\033[0m" << endl;
-        bao::Parser parser("test.bao", "test", tokens);
-        bao::ast::Program program = std::move(parser.parse_program());
+        const bao::AstCache cache(cache_directory);
+        std::optional<bao::ast::Program> cached = cache.load("test.bao", "test", source);
+        if (cached) {
+            cout << "Dùng cây cú pháp trong bộ nhớ đệm: " << cache.image_path("test.bao", "test") << endl;
+        } else {
+            bao::Lexer stream(source, sources.is_validated(file_id));
+            stream.set_collapse_newlines(true);
+            bao::Parser parser("test.bao", "test", stream);
+            cached.emplace(parser.parse_program());
+            // Failing to cache only costs the next compile a parse
+            try {
+                cache.store(*cached, source);
+            } catch (const std::exception& e) {
+                cout << "Cảnh báo: không thể lưu bộ nhớ đệm: " << e.what() << endl;
+            }
+        }
+        bao::ast::Program program = std::move(*cached);
         cout << "\033[32mPhân tích cú pháp thành công!\033[0m" << endl;
         bao::utils::ast::print_program(program);
 
@@ -210,19 +297,22 @@ void llvmTest() {
 
 void mirTest() {
     try {
-        const bao::Reader reader("test/test.bao");
-        const string source = reader.read();
+        bao::SourceManager& sources = bao::SourceManager::global();
+        const bao::FileId file_id = sources.load("test/test.bao");
+        const std::string_view source = sources.get_buffer(file_id);
         cout << "Nội dung tệp nguồn:" << endl;
         cout << source << endl;
         cout << "Đang phân loại ký hiệu..." << endl;
-        bao::Lexer lexer(source);
+        bao::Lexer lexer(source, sources.is_validated(file_id));
         lexer.tokenize();
-        vector<bao::Token> tokens = lexer.get_tokens();
+        const bao::TokenList& tokens = lexer.get_tokens();
         for (const auto& token : tokens) {
-            bao::utils::print_token(token);
+            bao::utils::print_token(tokens, token);
         }
         cout << "\033[33mĐang phân tích cú pháp...\033[0m" << endl;
-        bao::Parser parser("test.bao", "test", tokens);
+        bao::Lexer stream(source, sources.is_validated(file_id));
+        stream.set_collapse_newlines(true);
+        bao::Parser parser("test.bao", "test", stream);
         bao::ast::Program program = std::move(parser.parse_program());
         cout << "\033[32mPhân tích cú pháp thành công!\033[0m" << endl;
         bao::utils::ast::print_program(program);
@@ -244,19 +334,22 @@ void mirTest() {
 
 void semanticsTest() {
     try {
-        const bao::Reader reader("test/test.bao");
-        const string source = reader.read();
+        bao::SourceManager& sources = bao::SourceManager::global();
+        const bao::FileId file_id = sources.load("test/test.bao");
+        const std::string_view source = sources.get_buffer(file_id);
         cout << "Nội dung tệp nguồn:" << endl;
         cout << source << endl;
         cout << "Đang phân loại ký hiệu..." << endl;
-        bao::Lexer lexer(source);
+        bao::Lexer lexer(source, sources.is_validated(file_id));
         lexer.tokenize();
-        vector<bao::Token> tokens = lexer.get_tokens();
+        const bao::TokenList& tokens = lexer.get_tokens();
         for (const auto& token : tokens) {
-            bao::utils::print_token(token);
+            bao::utils::print_token(tokens, token);
         }
         cout << "Đang phân tích cú pháp..." << endl;
-        bao::Parser parser("test.bao", "test", tokens);
+        bao::Lexer stream(source, sources.is_validated(file_id));
+        stream.set_collapse_newlines(true);
+        bao::Parser parser("test.bao", "test", stream);
         bao::ast::Program program = std::move(parser.parse_program());
         cout << "Phân tích cú pháp thành công!" << endl;
         bao::utils::ast::print_program(program);
@@ -274,19 +367,22 @@ void semanticsTest() {
 // Test the parser
 void parserTest() {
     try {
-        const bao::Reader reader("test/test.bao");
-        const string source = reader.read();
+        bao::SourceManager& sources = bao::SourceManager::global();
+        const bao::FileId file_id = sources.load("test/test.bao");
+        const std::string_view source = sources.get_buffer(file_id);
         cout << "Nội dung tệp nguồn:" << endl;
         cout << source << endl;
         cout << "Đang phân loại ký hiệu..." << endl;
-        bao::Lexer lexer(source);
+        bao::Lexer lexer(source, sources.is_validated(file_id));
         lexer.tokenize();
-        vector<bao::Token> tokens = lexer.get_tokens();
+        const bao::TokenList& tokens = lexer.get_tokens();
         for (const auto& token : tokens) {
-            bao::utils::print_token(token);
+            bao::utils::print_token(tokens, token);
         }
         cout << "Đang phân tích cú pháp..." << endl;
-        bao::Parser parser("test.bao", "test", tokens);
+        bao::Lexer stream(source, sources.is_validated(file_id));
+        stream.set_collapse_newlines(true);
+        bao::Parser parser("test.bao", "test", stream);
         const bao::ast::Program& program = parser.parse_program();
         cout << "Phân tích cú pháp thành công!" << endl;
         bao::utils::ast::print_program(program);
@@ -295,18 +391,171 @@ void parserTest() {
     }
 }
 
+// 'E' only separates a variable from its type, it is no binary operator
+void operatorTest() {
+    const char* sources[] = {
+        "hàm f() -> Z32\n    biến a E Z32 := 3\n    trả về a E 2\nkết thúc\n",
+        "hàm f() -> Z32\n    biến a E Z32 := 3\n    biến b E Z32 := a E 2\n    trả về b\nkết thúc\n",
+    };
+    for (const char* text : sources) {
+        const string directory = write_source("toan_tu_e.bao", text);
+        bool rejected = false;
+        try {
+            bao::Lexer stream(text, true);
+            stream.set_collapse_newlines(true);
+            bao::Parser parser("toan_tu_e.bao", directory, stream);
+            static_cast<void>(parser.parse_program());
+        } catch ([[maybe_unused]] const exception& e) {
+            rejected = true;
+        }
+        cout << "'a E 2': " << (rejected ? "báo lỗi cú pháp" : "KHÔNG báo lỗi cú pháp") << endl;
+    }
+}
+
+// Diagnostics quote the source as it is now, a file rewritten after an earlier diagnostic is read again
+void diagnosticTest() {
+    string long_text;
+    for (int i = 1; i <= 400; i++) {
+        long_text += std::format("    biến cũ_{} E Z32 := {}\n", i, i);
+    }
+    const string short_text = "    biến mới_1 E Z32 := 1\n    biến mới_2 E Z32 := 2\n    biến mới_3 E Z32 := 3\n";
+    const string directory = write_source("viet_lai.bao", long_text);
+    const string before = bao::utils::CompilerError::new_error("viet_lai.bao", directory, "Lỗi", 3, 5).what();
+    write_source("viet_lai.bao", short_text);
+    bool past_end = false;
+    try {
+        static_cast<void>(bao::utils::CompilerError::new_error("viet_lai.bao", directory, "Lỗi", 300, 5));
+    } catch ([[maybe_unused]] const std::out_of_range& e) {
+        past_end = true;
+    }
+    const string after = bao::utils::CompilerError::new_error("viet_lai.bao", directory, "Lỗi", 3, 5).what();
+    const bool fresh = before.starts_with("    biến cũ_3 ") && after.starts_with("    biến mới_3 ") && past_end;
+    cout << "Tệp viết lại: " << (fresh ? "trích dòng mới" : "KHÔNG trích dòng mới") << endl;
+
+    // The parser quotes the source it lexed, which need not be on disk at all
+    const string text = "hàm f() -> Z32\n    trả về * 2\nkết thúc\n";
+    string error;
+    try {
+        bao::Lexer stream(text, true);
+        stream.set_collapse_newlines(true);
+        bao::Parser parser("khong_co.bao", "khong_co", stream);
+        static_cast<void>(parser.parse_program());
+    } catch (const exception& e) {
+        error = e.what();
+    }
+    cout << "Lỗi cú pháp của nguồn không có tệp: " << (error.starts_with("    trả về * 2\n") ? "trích dòng đã phân loại" : "KHÔNG trích dòng đã phân loại") << endl;
+}
+
+// The parallel lexer, parser and analyzer must give what the sequential ones give, programs and errors alike
+void parallelTest() {
+    // Past the size the lexer, the parser and the analyzer split at
+    constexpr int FUNCTIONS = 10000;
+    const string source = generated_program(FUNCTIONS);
+    // A broken function in the middle sends the parallel parse back to the sequential one
+    string unparsable = source;
+    unparsable.insert(unparsable.size() / 2, "\nhàm hỏng(\n");
+    // Every so often an undeclared variable and a mismatched type
+    string ill_typed = source;
+    for (int i = 0; i < FUNCTIONS; i += 997) {
+        const string target = std::format("hàm f{}() -> Z32\n    biến a E Z32 := 3\n", i);
+        ill_typed.insert(ill_typed.find(target) + target.size(), "    c := a + 1\n    biến d E R64 := a\n");
+    }
+
+    const auto tokens = on_threads([&](const unsigned threads) {
+        bao::Lexer lexer(source, true);
+        lexer.set_collapse_newlines(true);
+        lexer.tokenize_parallel(threads);
+        const bao::TokenList& list = lexer.get_tokens();
+        return std::pair(vector<bao::Token>(list.begin(), list.end()), list.get_line_starts());
+    });
+
+    // The dump of the program and the errors, one of them empty
+    auto parse = [](const string& text, const unsigned threads) -> std::pair<string, string> {
+        try {
+            bao::Lexer lexer(text, true);
+            lexer.set_collapse_newlines(true);
+            lexer.tokenize();
+            bao::Parser parser("song_song.bao", "bench", lexer.get_tokens());
+            return {dump_program(threads > 1 ? parser.parse_program_parallel(threads) : parser.parse_program()), ""};
+        } catch (exception& e) {
+            return {"", e.what()};
+        }
+    };
+    const auto parsed = on_threads([&](const unsigned threads) { return parse(source, threads); });
+    const auto unparsed = on_threads([&](const unsigned threads) { return parse(unparsable, threads); });
+
+    auto analyze = [](const string& text, const unsigned threads) -> std::pair<string, string> {
+        const string directory = write_source("ngu_nghia.bao", text);
+        try {
+            bao::Lexer lexer(text, true);
+            lexer.set_collapse_newlines(true);
+            bao::Parser parser("ngu_nghia.bao", directory, lexer);
+            bao::Analyzer analyzer(parser.parse_program());
+            return {dump_program(analyzer.analyze_program_parallel(threads)), ""};
+        } catch (exception& e) {
+            return {"", e.what()};
+        }
+    };
+    const auto analyzed = on_threads([&](const unsigned threads) { return analyze(source, threads); });
+    const auto unanalyzed = on_threads([&](const unsigned threads) { return analyze(ill_typed, threads); });
+
+    cout << "Lexer::tokenize_parallel " << CHECK_THREADS << " luồng: " << (tokens ? "khớp" : "KHÔNG KHỚP") << endl;
+    cout << "Parser::parse_program_parallel " << CHECK_THREADS << " luồng: "
+         << (parsed && parsed->second.empty() && unparsed && !unparsed->second.empty() ? "khớp" : "KHÔNG KHỚP") << endl;
+    cout << "Analyzer::analyze_program_parallel " << CHECK_THREADS << " luồng: "
+         << (analyzed && analyzed->second.empty() && unanalyzed && !unanalyzed->second.empty() ? "khớp" : "KHÔNG KHỚP") << endl;
+}
+
+// Skimmed bodies parsed on first access must give the program and errors of an eager parse
+void lazyBodyTest() {
+    // The dump of the program with every body parsed, and the errors, one of them empty
+    auto parse = [](const string& text, const bool lazy) -> std::pair<string, string> {
+        try {
+            bao::Lexer lexer(text, true);
+            lexer.set_collapse_newlines(true);
+            lexer.tokenize();
+            bao::Parser parser("than_ham.bao", "bench", lexer.get_tokens());
+            parser.set_lazy_bodies(lazy);
+            const bao::ast::Program program = parser.parse_program();
+            program.force_bodies();
+            return {dump_program(program), ""};
+        } catch (exception& e) {
+            return {"", e.what()};
+        }
+    };
+    constexpr int FUNCTIONS = 100;
+    const string source = generated_program(FUNCTIONS);
+    string bad_body = source;
+    const string target = std::format("hàm f{}() -> Z32\n", FUNCTIONS / 2);
+    bad_body.insert(bad_body.find(target) + target.size(), "    b := * 2\n");
+    const string texts[] = {
+        source,
+        bad_body,
+        // A 'kết thúc' inside a line ends the body there, skimming must not skip past it
+        "hàm f() -> Z32\n    trả về 1 kết thúc\n    kết thúc\n",
+        "hàm f() -> Z32\n    trả về 2 kết thúc\nkết thúc\n",
+    };
+    bool same = true;
+    for (size_t i = 0; i < std::size(texts); i++) {
+        const auto eager = parse(texts[i], false);
+        same = same && eager == parse(texts[i], true) && eager.second.empty() == (i == 0);
+    }
+    cout << "Parser chỉ chữ ký, thân hàm phân tích sau: " << (same ? "khớp" : "KHÔNG KHỚP") << endl;
+}
+
 // Test the lexer
 void lexerTest() {
     try {
-        const bao::Reader reader("test/test.bao");
-        const string source = reader.read();
+        bao::SourceManager& sources = bao::SourceManager::global();
+        const bao::FileId file_id = sources.load("test/test.bao");
+        const std::string_view source = sources.get_buffer(file_id);
         cout << "Nội dung tệp nguồn:" << endl;
         cout << source << endl;
         cout << "Đang phân tích cú pháp..." << endl;
-        bao::Lexer lexer(source);
+        bao::Lexer lexer(source, sources.is_validated(file_id));
         lexer.tokenize();
-        for (const auto tokens = lexer.get_tokens(); const auto& token : tokens) {
-            bao::utils::print_token(token);
+        for (const bao::TokenList& tokens = lexer.get_tokens(); const auto& token : tokens) {
+            bao::utils::print_token(tokens, token);
         }
     } catch (exception& e) {
         cerr << "Gặp sự cố trong quá trình phân tích cú pháp:" << endl << e.what() << endl;
@@ -336,6 +585,568 @@ void readerTest() {
     }
 }
 
+// Compare UTF-8 validation against decoding through ICU
+void utf8Benchmark() {
+    // Mostly ASCII code with Vietnamese identifiers, like real sources
+    const string line = "hàm tính_tổng(số_a: N32, số_b: N32) -> N32 { trả về số_a + số_b; }\n";
+    string text;
+    while (text.size() < (64 << 20)) {
+        text += line;
+    }
+    const std::string_view view = text;
+
+    auto measure = [&](const char* name, auto&& run) {
+        const auto start = std::chrono::steady_clock::now();
+        size_t result = 0;
+        for (int i = 0; i < 5; i++) {
+            result += run();
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        const double mb = static_cast<double>(view.size()) * 5 / (1 << 20);
+        cout << name << ": " << mb / elapsed.count() << " MB/s (" << result << ")" << endl;
+    };
+
+    // Ill-formed sequences, and well-formed ones for contrast, at every offset around the 16, 32 and 64 byte blocks
+    const std::string_view sequences[] = {
+        "\xC0\xAF", "\xE0\x80\xAF", "\xF0\x80\x80\xAF", // Overlong
+        "\xED\xA0\x80", "\xED\xBF\xBF", // Surrogates
+        "\xF4\x90\x80\x80", "\xF5\x80\x80\x80", // Above U+10FFFF
+        "\x80", "\xBF", "à\x80", // Stray continuation bytes
+        "\xE1\xBB", "\xF0\x9F\x98", // Incomplete
+        "ệ", "\xF0\x9F\x98\x80", // Well-formed
+    };
+    constexpr size_t WELL_FORMED = 12; // Index of the first well-formed sequence
+    size_t cases = 0;
+    bool same = true;
+    for (size_t i = 0; i < std::size(sequences); i++) {
+        const std::string_view sequence = sequences[i];
+        for (size_t at = 0; at < 130; at++) {
+            // In the middle of the text, then cut at the end of the input
+            for (const bool last : {false, true}) {
+                string sample(at, 'a');
+                sample += sequence;
+                if (!last) {
+                    sample += string(70, 'b');
+                }
+                const size_t invalid = bao::utf8::validate(sample);
+                same = same && invalid == bao::utf8::validate_scalar(sample)
+                    && (invalid == sample.size()) == (i >= WELL_FORMED);
+                cases++;
+            }
+        }
+    }
+    cout << "utf8::validate trên " << cases << " chuỗi có chuỗi con sai hoặc bị cắt: "
+         << (same ? "khớp" : "KHÔNG khớp") << " với validate_scalar" << endl;
+
+    measure("utf8::validate", [&] { return bao::utf8::validate(view); });
+    measure("utf8::validate_scalar", [&] { return bao::utf8::validate_scalar(view); });
+    measure("UnicodeString::fromUTF8", [&] {
+        return static_cast<size_t>(UnicodeString::fromUTF8(view).length());
+    });
+}
+
+// Measure tokenize() on the test program repeated into a larger corpus, sequentially and in parallel
+void lexerBenchmark() {
+    try {
+        bao::SourceManager& sources = bao::SourceManager::global();
+        const bao::FileId file_id = sources.load("test/test.bao");
+        string corpus;
+        while (corpus.size() < (50 << 20)) {
+            corpus += sources.get_buffer(file_id);
+        }
+        const double mb = static_cast<double>(corpus.size()) / (1 << 20);
+
+        auto start = std::chrono::steady_clock::now();
+        bao::Lexer lexer(corpus, sources.is_validated(file_id));
+        lexer.tokenize();
+        const bao::TokenList& tokens = lexer.get_tokens();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        cout << "Lexer::tokenize: " << mb / elapsed.count() << " MB/s (" << tokens.size() << " tokens)" << endl;
+
+        start = std::chrono::steady_clock::now();
+        bao::Lexer parallel_lexer(corpus, sources.is_validated(file_id));
+        parallel_lexer.tokenize_parallel();
+        const bao::TokenList& parallel_tokens = parallel_lexer.get_tokens();
+        elapsed = std::chrono::steady_clock::now() - start;
+        cout << "Lexer::tokenize_parallel (" << bao::parallel::worker_count() << " luồng): "
+             << mb / elapsed.count() << " MB/s (" << parallel_tokens.size() << " tokens)" << endl;
+    } catch (exception& e) {
+        cerr << "Gặp sự cố trong quá trình phân tích cú pháp:" << endl << e.what() << endl;
+    }
+}
+
+// Lexing identifier pairs has to scale linearly, including pairs that only look like keywords
+void keywordBenchmark() {
+    const char* pairs[] = {"trả lời ", "kết thúc ", "số_a số_b ", "thủ tục ", "không biết "};
+    for (const int count : {25000, 50000, 100000}) {
+        string source;
+        for (int i = 0; i < count; i++) {
+            source += pairs[i % 5];
+            if (i % 8 == 7) {
+                source += "\n";
+            }
+        }
+        const auto start = std::chrono::steady_clock::now();
+        bao::Lexer lexer(source, true);
+        lexer.tokenize();
+        const size_t tokens = lexer.get_tokens().size();
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        cout << "Lexer::tokenize " << count << " cặp định danh: " << elapsed.count() / count
+             << " ns/cặp (" << tokens << " tokens)" << endl;
+    }
+}
+
+// A one character edit in a 100k-line file has to cost about one line, not the file
+void relexBenchmark() {
+    try {
+        bao::SourceManager& sources = bao::SourceManager::global();
+        const bao::FileId file_id = sources.load("test/test.bao");
+        const std::string_view program = sources.get_buffer(file_id);
+        string source;
+        size_t lines = 0;
+        while (lines < 100000) {
+            source += program;
+            lines += std::count(program.begin(), program.end(), '\n');
+        }
+        auto start = std::chrono::steady_clock::now();
+        bao::Lexer lexer(source, true);
+        lexer.tokenize();
+        bao::TokenList tokens = lexer.get_tokens();
+        const std::chrono::duration<double, std::micro> full = std::chrono::steady_clock::now() - start;
+
+        // Rename an identifier in the middle of the file
+        const size_t offset = source.find("a :=", source.size() / 2);
+        string edited = source;
+        edited.insert(offset, "x");
+        start = std::chrono::steady_clock::now();
+        bao::Lexer::relex(tokens, edited, bao::Edit{offset, 0, 1}, true);
+        const std::chrono::duration<double, std::micro> incremental = std::chrono::steady_clock::now() - start;
+
+        // Re-lexing must leave the tokens and line starts a fresh tokenize() of the edited source gives
+        auto same_as_fresh = [](const bao::TokenList& relexed, const string& text, const bool collapse) {
+            bao::Lexer fresh(text, true);
+            fresh.set_collapse_newlines(collapse);
+            fresh.tokenize();
+            const bao::TokenList& expected = fresh.get_tokens();
+            return std::ranges::equal(relexed, expected) && relexed.get_line_starts() == expected.get_line_starts();
+        };
+        auto relex_matches = [&](const string& text, const size_t at, const size_t removed, const string& inserted, const bool collapse) {
+            bao::Lexer old_lexer(text, true);
+            old_lexer.set_collapse_newlines(collapse);
+            old_lexer.tokenize();
+            bao::TokenList relexed = old_lexer.get_tokens();
+            string changed = text;
+            changed.replace(at, removed, inserted);
+            bao::Lexer::relex(relexed, changed, bao::Edit{at, removed, inserted.size()}, true);
+            return same_as_fresh(relexed, changed, collapse);
+        };
+        bool same = same_as_fresh(tokens, edited, false);
+        // An edit opening a block comment, one closing it earlier, and one inside a collapsed run of blank lines
+        const string opened = "a := 1\nb := 2 */ c := 3\nd := 4\n";
+        same = same && relex_matches(opened, opened.find('\n'), 0, " /*", false);
+        const string closed = "a := 1 /* b := 2\nc := 3 */ d := 4\ne := 5\n";
+        same = same && relex_matches(closed, closed.find('\n'), 0, " */", false);
+        const string blank = "a := 1\n\n// chú thích\n\n\nb := 2\n";
+        same = same && relex_matches(blank, blank.find("\n\n\nb"), 0, "\nc := 3", true);
+
+        cout << "Lexer::tokenize " << lines << " dòng: " << full.count() << " µs, Lexer::relex 1 ký tự: "
+             << incremental.count() << " µs (" << tokens.size() << " tokens, "
+             << (same ? "khớp" : "KHÔNG khớp") << " với tokenize)" << endl;
+    } catch (exception& e) {
+        cerr << "Gặp sự cố trong quá trình phân tích cú pháp:" << endl << e.what() << endl;
+    }
+}
+
+// Comments are skipped without looking at their contents, so heavily commented code lexes at about memcpy speed
+void commentBenchmark() {
+    const string block =
+        "// Hàm sinh tự động, không sửa tay\n"
+        "/* Tham số: không có\n"
+        " * Trả về: Z32 */\n"
+        "hàm f() -> Z32 // điểm vào\n"
+        "    trả về 1\n"
+        "kết thúc\n\n";
+    string source;
+    while (source.size() < (50 << 20)) {
+        source += block;
+    }
+    const double mb = static_cast<double>(source.size()) / (1 << 20);
+    for (const bool collapse : {false, true}) {
+        const auto start = std::chrono::steady_clock::now();
+        bao::Lexer lexer(source, true);
+        lexer.set_collapse_newlines(collapse);
+        lexer.tokenize();
+        const size_t count = lexer.get_tokens().size();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        cout << "Lexer::tokenize chú thích" << (collapse ? ", gộp dòng trống: " : ": ") << mb / elapsed.count()
+             << " MB/s (" << count << " tokens)" << endl;
+    }
+}
+
+// Lexers running in parallel share the interner, every thread has to see the same symbol for a name
+void internerBenchmark() {
+    constexpr int NAMES = 100000;
+    constexpr int THREADS = 4;
+    vector<string> names;
+    for (int i = 0; i < NAMES; i++) {
+        names.push_back("biến_" + std::to_string(i));
+    }
+    vector<vector<bao::Symbol>> symbols(THREADS, vector<bao::Symbol>(NAMES));
+    bao::Interner& interner = bao::Interner::global();
+    const auto start = std::chrono::steady_clock::now();
+    vector<std::thread> workers;
+    for (int t = 0; t < THREADS; t++) {
+        workers.emplace_back([&, t] {
+            for (int i = 0; i < NAMES; i++) {
+                symbols[t][i] = interner.intern(names[(i + t * NAMES / THREADS) % NAMES]);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    bool same = true;
+    for (int t = 0; t < THREADS; t++) {
+        for (int i = 0; i < NAMES; i++) {
+            const int name = (i + t * NAMES / THREADS) % NAMES;
+            same = same && symbols[t][i] == symbols[0][name] && interner.name(symbols[t][i]) == names[name];
+        }
+    }
+    cout << "Interner::intern " << THREADS << " luồng: " << elapsed.count() / (NAMES * THREADS)
+         << " ns/tên (" << (same ? "khớp" : "KHÔNG KHỚP") << ")" << endl;
+}
+
+// Analysis and translation visit every node once, the cost per node must not depend on its kind
+void semanticsBenchmark() {
+    constexpr int FUNCTIONS = 20000;
+    const string source = generated_program(FUNCTIONS);
+    try {
+        bao::Lexer stream(source, true);
+        stream.set_collapse_newlines(true);
+        bao::Parser parser("bench.bao", "bench", stream);
+        bao::ast::Program program = parser.parse_program();
+        const auto start = std::chrono::steady_clock::now();
+        bao::Analyzer analyzer(std::move(program));
+        program = analyzer.analyze_program();
+        const auto analyzed = std::chrono::steady_clock::now();
+        bao::mir::Translator translator(std::move(program));
+        const bao::mir::Module mod = translator.translate();
+        const auto translated = std::chrono::steady_clock::now();
+        const std::chrono::duration<double, std::milli> analysis = analyzed - start;
+        const std::chrono::duration<double, std::milli> translation = translated - analyzed;
+        cout << "Analyzer + Translator " << FUNCTIONS << " hàm: " << analysis.count() << " ms + "
+             << translation.count() << " ms (" << mod.functions.size() << " hàm MIR)" << endl;
+    } catch (exception& e) {
+        cerr << "Gặp sự cố trong quá trình phân tích ngữ nghĩa:" << endl << e.what() << endl;
+    }
+}
+
+// Analyzing the functions in parallel has to pay off on a large program, parallelTest checks what it gives
+void analyzerBenchmark() {
+    constexpr int FUNCTIONS = 20000;
+    const string source = generated_program(FUNCTIONS);
+    auto analyze = [&](const unsigned threads) {
+        bao::Lexer lexer(source, true);
+        lexer.set_collapse_newlines(true);
+        bao::Parser parser("ngu_nghia.bao", "bench", lexer);
+        bao::Analyzer analyzer(parser.parse_program());
+        const auto start = std::chrono::steady_clock::now();
+        static_cast<void>(analyzer.analyze_program_parallel(threads));
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    };
+    try {
+        const unsigned threads = bao::parallel::worker_count();
+        const double sequential_ms = analyze(1);
+        const double parallel_ms = analyze(threads);
+        cout << "Analyzer " << FUNCTIONS << " hàm: tuần tự " << sequential_ms << " ms, song song ("
+             << threads << " luồng) " << parallel_ms << " ms" << endl;
+    } catch (exception& e) {
+        cerr << "Gặp sự cố trong quá trình phân tích ngữ nghĩa:" << endl << e.what() << endl;
+    }
+}
+
+// Parsing the functions in parallel, or only their signatures, has to pay off on a large program.
+// parallelTest and lazyBodyTest check what they give
+void parserBenchmark() {
+    constexpr int FUNCTIONS = 20000;
+    const string source = generated_program(FUNCTIONS);
+    try {
+        bao::Lexer lexer(source, true);
+        lexer.set_collapse_newlines(true);
+        lexer.tokenize_parallel();
+        const bao::TokenList& tokens = lexer.get_tokens();
+        // One thread parses sequentially
+        auto parse = [&](const unsigned threads) {
+            const auto start = std::chrono::steady_clock::now();
+            bao::Parser parser("song_song.bao", "bench", tokens);
+            static_cast<void>(threads > 1 ? parser.parse_program_parallel(threads) : parser.parse_program());
+            const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            return elapsed.count();
+        };
+        const double sequential_ms = parse(1);
+        const double parallel_ms = parse(bao::parallel::worker_count());
+        cout << "Parser " << FUNCTIONS << " hàm: tuần tự " << sequential_ms << " ms, song song ("
+             << bao::parallel::worker_count() << " luồng) " << parallel_ms << " ms" << endl;
+
+        // Signatures only, the bodies are parsed when forced
+        auto start = std::chrono::steady_clock::now();
+        bao::Parser parser("song_song.bao", "bench", tokens);
+        parser.set_lazy_bodies(true);
+        const bao::ast::Program skimmed = parser.parse_program();
+        const std::chrono::duration<double, std::milli> skim = std::chrono::steady_clock::now() - start;
+        start = std::chrono::steady_clock::now();
+        skimmed.force_bodies();
+        const std::chrono::duration<double, std::milli> forced = std::chrono::steady_clock::now() - start;
+        cout << "Parser chỉ chữ ký " << FUNCTIONS << " hàm: " << skim.count() << " ms, phân tích thân hàm sau: "
+             << forced.count() << " ms" << endl;
+    } catch (exception& e) {
+        cerr << "Gặp sự cố trong quá trình phân tích cú pháp:" << endl << e.what() << endl;
+    }
+}
+
+// Generated expressions can have a million terms, compiling them must take linear time and bounded native stack
+void expressionBenchmark() {
+    auto compile = [](const int terms) {
+        string source = "hàm f() -> Z32\n    biến a E Z32 := 3\n    trả về a";
+        for (int i = 1; i < terms; i++) {
+            source += i % 3 == 0 ? " * (a - 1)" : i % 3 == 1 ? " + a" : " - 2";
+        }
+        source += "\nkết thúc\n";
+        const auto start = std::chrono::steady_clock::now();
+        bao::Lexer stream(source, true);
+        stream.set_collapse_newlines(true);
+        bao::Parser parser("bench.bao", "bench", stream);
+        bao::Analyzer analyzer(parser.parse_program());
+        const auto parsed = std::chrono::steady_clock::now();
+        bao::mir::Translator translator(analyzer.analyze_program());
+        const auto analyzed = std::chrono::steady_clock::now();
+        const bao::mir::Module mod = translator.translate();
+        const auto translated = std::chrono::steady_clock::now();
+        const std::chrono::duration<double, std::milli> parsing = parsed - start;
+        const std::chrono::duration<double, std::milli> analysis = analyzed - parsed;
+        const std::chrono::duration<double, std::milli> translation = translated - analyzed;
+        cout << "Biểu thức " << terms << " số hạng: " << parsing.count() << " ms + " << analysis.count()
+             << " ms + " << translation.count() << " ms ("
+             << mod.functions.front().blocks.back().instructions.size() << " lệnh MIR)" << endl;
+    };
+    try {
+        compile(250000);
+        compile(1000000);
+    } catch (exception& e) {
+        cerr << "Gặp sự cố trong quá trình biên dịch biểu thức:" << endl << e.what() << endl;
+    }
+
+    // Parentheses nested past the limit are a diagnostic, not a crash
+    constexpr size_t DEPTH = 100000;
+    const string nested = "hàm f() -> Z32\n    biến a E Z32 := " + string(DEPTH, '(') + "1" + string(DEPTH, ')') + "\nkết thúc\n";
+    const string directory = write_source("ngoac.bao", nested);
+    string error;
+    try {
+        bao::Lexer stream(nested, true);
+        bao::Parser parser("ngoac.bao", directory, stream);
+        static_cast<void>(parser.parse_program());
+    } catch (exception& e) {
+        error = e.what();
+    }
+    bool parsed = false;
+    try {
+        bao::Lexer stream(nested, true);
+        bao::Parser parser("ngoac.bao", directory, stream);
+        parser.set_max_nesting(DEPTH);
+        parsed = parser.parse_program().funcs.size() == 1;
+    } catch (exception& e) {
+        cerr << "Gặp sự cố trong quá trình phân tích cú pháp:" << endl << e.what() << endl;
+    }
+    cout << DEPTH << " cấp ngoặc: " << (error.contains("lồng nhau quá sâu") ? "báo lỗi" : "KHÔNG báo lỗi")
+         << " với giới hạn mặc định, " << (parsed ? "phân tích được" : "KHÔNG phân tích được")
+         << " với giới hạn " << DEPTH << endl;
+}
+
+// A warm run maps the images of unchanged files instead of lexing and parsing them again
+void cacheBenchmark() {
+    constexpr int FILES = 32;
+    constexpr int FUNCTIONS = 2000;
+    vector<string> names;
+    string directory;
+    const string source = generated_program(FUNCTIONS);
+    for (int file = 0; file < FILES; file++) {
+        names.push_back(std::format("du_an_{}.bao", file));
+        directory = write_source(names.back(), source);
+    }
+    const bao::AstCache cache((std::filesystem::path(directory) / "cache").string());
+    std::filesystem::remove_all(std::filesystem::path(directory) / "cache");
+
+    // Read, lex and parse every file, or load its image, the way a compile would
+    auto front_end = [&](vector<bao::ast::Program>& programs, size_t& hits, const bool force) {
+        bao::SourceManager sources;
+        hits = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (const string& name : names) {
+            const bao::FileId id = sources.load((std::filesystem::path(directory) / name).string());
+            const std::string_view source = sources.get_buffer(id);
+            if (auto cached = cache.load(name, directory, source)) {
+                if (force) {
+                    cached->force_bodies();
+                }
+                programs.push_back(std::move(*cached));
+                hits++;
+                continue;
+            }
+            bao::Lexer lexer(source, sources.is_validated(id));
+            lexer.set_collapse_newlines(true);
+            bao::Parser parser(name, directory, lexer);
+            programs.push_back(parser.parse_program());
+            cache.store(programs.back(), source);
+        }
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    };
+    try {
+        vector<bao::ast::Program> cold;
+        vector<bao::ast::Program> warm;
+        size_t cold_hits = 0;
+        size_t warm_hits = 0;
+        const double cold_ms = front_end(cold, cold_hits, true);
+        const double warm_ms = front_end(warm, warm_hits, true);
+        vector<bao::ast::Program> headers;
+        const double headers_ms = front_end(headers, warm_hits, false);
+        bool same = cold_hits == 0 && warm_hits == names.size();
+        for (size_t i = 0; same && i < cold.size(); i += cold.size() / 4) {
+            same = dump_program(cold[i]) == dump_program(warm[i]);
+        }
+
+        // An analyzed program comes back with its types
+        bao::Analyzer analyzer(std::move(cold.front()));
+        const bao::ast::Program analyzed = analyzer.analyze_program();
+        bao::SourceManager sources;
+        const bao::FileId id = sources.load((std::filesystem::path(directory) / names.front()).string());
+        cache.store(analyzed, sources.get_buffer(id), true);
+        const auto typed = cache.load(names.front(), directory, sources.get_buffer(id), true);
+        same = same && typed && dump_program(analyzed) == dump_program(*typed)
+            && !cache.load(names.front(), directory, sources.get_buffer(id));
+
+        // An edited file misses, its image is replaced
+        const string edited = string(sources.get_buffer(id)) + "hàm g() -> Z32\n    trả về 1\nkết thúc\n";
+        same = same && !cache.load(names.front(), directory, edited, true);
+
+        cout << "Bộ nhớ đệm AST " << FILES << " tệp x " << FUNCTIONS << " hàm: lạnh " << cold_ms
+             << " ms, ấm " << warm_ms << " ms, ấm chỉ chữ ký " << headers_ms << " ms (" << (same ? "khớp" : "KHÔNG KHỚP") << ")" << endl;
+    } catch (exception& e) {
+        cerr << "Gặp sự cố trong quá trình dùng bộ nhớ đệm AST:" << endl << e.what() << endl;
+    }
+}
+
+// Entering, declaring in and leaving deeply nested scopes must not depend on the depth
+void symbolTableBenchmark() {
+    constexpr int DEPTH = 500;
+    constexpr int LOCALS = 64;
+    constexpr int LOOKUPS = 32;
+    constexpr int NAMES = 512; // Only the first half is ever declared
+    constexpr int ROUNDS = 4;
+    vector<bao::Symbol> names;
+    for (int i = 0; i < NAMES; i++) {
+        names.push_back(bao::Interner::global().intern("cục_bộ_" + std::to_string(i)));
+    }
+    const bao::TypeContext& types = bao::TypeContext::builtins();
+    auto info_of = [&](const int depth, const int local) {
+        return bao::sema::SymbolInfo{
+            bao::sema::SymbolType::Variable, types.primitive(static_cast<bao::Primitive>((depth + local) % 6)), false
+        };
+    };
+    // Names declared at a depth, distinct within it and shadowing the ones of the depths around it
+    auto name_of = [&](const int depth, const int local) {
+        return names[(depth + local * 4) % (NAMES / 2)];
+    };
+
+    vector<const bao::Type*> flat_results;
+    bao::sema::SymbolTable table;
+    const auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < ROUNDS; round++) {
+        uint32_t seed = 12345;
+        for (int depth = 0; depth < DEPTH; depth++) {
+            table.enter_scope();
+            for (int local = 0; local < LOCALS; local++) {
+                table.insert(name_of(depth, local), info_of(depth, local));
+            }
+            for (int i = 0; i < LOOKUPS; i++) {
+                seed = seed * 1103515245u + 12345u;
+                const bao::sema::SymbolInfo* info = table.lookup(names[(seed >> 8) % NAMES]);
+                flat_results.push_back(info ? info->datatype : nullptr);
+            }
+        }
+        for (int depth = 0; depth < DEPTH; depth++) {
+            table.leave_scope();
+        }
+    }
+    const std::chrono::duration<double, std::nano> flat = std::chrono::steady_clock::now() - start;
+
+    // A map per scope walked outwards, the way scopes used to be resolved
+    vector<const bao::Type*> chained_results;
+    vector<std::unordered_map<bao::Symbol, bao::sema::SymbolInfo>> scopes;
+    const auto chained_start = std::chrono::steady_clock::now();
+    for (int round = 0; round < ROUNDS; round++) {
+        uint32_t seed = 12345;
+        for (int depth = 0; depth < DEPTH; depth++) {
+            scopes.emplace_back();
+            for (int local = 0; local < LOCALS; local++) {
+                scopes.back().emplace(name_of(depth, local), info_of(depth, local));
+            }
+            for (int i = 0; i < LOOKUPS; i++) {
+                seed = seed * 1103515245u + 12345u;
+                const bao::Symbol name = names[(seed >> 8) % NAMES];
+                const bao::sema::SymbolInfo* info = nullptr;
+                for (auto scope = scopes.rbegin(); !info && scope != scopes.rend(); ++scope) {
+                    if (const auto it = scope->find(name); it != scope->end()) {
+                        info = &it->second;
+                    }
+                }
+                chained_results.push_back(info ? info->datatype : nullptr);
+            }
+        }
+        scopes.clear();
+    }
+    const std::chrono::duration<double, std::nano> chained = std::chrono::steady_clock::now() - chained_start;
+
+    constexpr double operations = static_cast<double>(ROUNDS) * DEPTH * (LOCALS + LOOKUPS);
+    cout << "SymbolTable " << DEPTH << " cấp lồng nhau, " << LOCALS << " biến/cấp: " << flat.count() / operations
+         << " ns/thao tác, bảng theo từng cấp " << chained.count() / operations << " ns/thao tác ("
+         << (flat_results == chained_results ? "khớp" : "KHÔNG KHỚP") << ")" << endl;
+}
+
+// The functions every benchmark compiles, short bodies with a bit of arithmetic
+string generated_program(const int functions) {
+    string source;
+    for (int i = 0; i < functions; i++) {
+        source += std::format(
+            "hàm f{}() -> Z32\n"
+            "    biến a E Z32 := 3\n"
+            "    biến b E Z32 := a + 1\n"
+            "    b := a * b - a / 2 + (b - 1) * 3\n"
+            "    trả về (1 + a) * b\n"
+            "kết thúc\n\n", i);
+    }
+    return source;
+}
+
+// What print_program() writes, to compare programs built different ways
+string dump_program(const bao::ast::Program& program) {
+    std::ostringstream out;
+    std::streambuf* previous = cout.rdbuf(out.rdbuf());
+    bao::utils::ast::print_program(program);
+    cout.rdbuf(previous);
+    return out.str();
+}
+
+// Diagnostics quote their line from the file on disk, so generated sources are written out first
+string write_source(const string& name, const string& text) {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "bao_bench";
+    std::filesystem::create_directories(directory);
+    std::ofstream(directory / name, std::ios::binary) << text;
+    return directory.string();
+}
+
 // int icuTest() {
 //     // Error code object
 //     UErrorCode errorCode = U_ZERO_ERROR;
@@ -0,0 +1,13 @@
+#include <bao/types.h>
+
+bao::TypeContext::TypeContext() : unknown_type(new UnknownType()) {
+    for (const auto& [name, primitive] : primitive_map) {
+        this->primitives[static_cast<size_t>(primitive)].reset(new PrimitiveType(name, primitive));
+    }
+}
+
+auto
+bao::TypeContext::builtins() -> const bao::TypeContext& {
+    static TypeContext context;
+    return context;
+}
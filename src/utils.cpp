@@ -40,14 +40,31 @@ bool bao::utils::arg_contains(const int argc, char *argv[], const char *target)
     return false;
 }
 
+const char* bao::utils::arg_value(const int argc, char *argv[], const char *target) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (strcmp(argv[i], target) == 0) {
+            return argv[i + 1];
+        }
+    }
+    return nullptr;
+}
+
 void bao::utils::print_usage() {
-    cout << "Cú pháp: baoc [--test] [--huong-dan]" << endl;
+    cout << "Cú pháp: baoc [--test [--bench]] [--bo-nho-dem <thư mục>] [--huong-dan]" << endl;
     cout << "--test: Chạy tests" << endl;
+    cout << "--bench: Chạy đo hiệu năng (dùng cùng --test)" << endl;
+    cout << "--bo-nho-dem: Thư mục lưu cây cú pháp đã phân tích, mặc định là .bao_cache trong thư mục của tệp nguồn" << endl;
     cout << "--huong-dan: Hiện thông tin về cách sử dụng" << endl;
 }
 
-void bao::utils::print_token(const Token &token) {
-    cout << "Token: " << token.value << ", Loại: " << token_type_map.at(token.type) << ", Dòng: " << token.line << ", Cột: " << token.column << endl;
+void bao::utils::print_token(const TokenList &tokens, const Token &token) {
+    std::string_view value = tokens.text(token);
+    if (token.type == TokenType::Newline) {
+        value = "\\n";
+    } else if (token.type == TokenType::EndOfFile) {
+        value = "\\0";
+    }
+    cout << "Token: " << value << ", Loại: " << token_type_name(token.type) << ", Dòng: " << token.line << ", Cột: " << tokens.column(token) << endl;
 }
 
 void bao::utils::ast::print_program(const bao::ast::Program &program) {
@@ -68,8 +85,8 @@ void bao::utils::ast::print_function(const bao::ast::FuncNode& func, const strin
         func.get_name(), type, func.get_return_type()->get_name(),
         line, column);
     cout << pad_lines(message, padding) << endl;
-    for (const auto& stmt_ptr : func.get_stmts()) {
-        ast::print_statement(stmt_ptr.get(), padding + " | ");
+    for (bao::ast::StmtNode* stmt_ptr : func.get_stmts()) {
+        ast::print_statement(stmt_ptr, padding + " | ");
     }
 }
 
@@ -81,46 +98,58 @@ void bao::utils::ast::print_statement(bao::ast::StmtNode* stmt, const string &pa
     auto [line, column] = stmt->pos();
     const auto message = std::format("{} (Dòng {}, Cột {}):", stmt->get_name(), line, column);
     cout << pad_lines(message, padding) << endl;
-    if (const auto ret_stmt = dynamic_cast<bao::ast::RetStmt*>(stmt)) {
-        if (ret_stmt->get_val()) {
-            ast::print_expression(ret_stmt->get_val(), padding);
+    switch (stmt->get_kind()) {
+        case bao::ast::NodeKind::RetStmt: {
+            const auto ret_stmt = bao::cast<bao::ast::RetStmt>(stmt);
+            if (ret_stmt->get_val()) {
+                ast::print_expression(ret_stmt->get_val(), padding);
+                std::cout << std::endl;
+            }
+            break;
+        }
+        case bao::ast::NodeKind::VarDeclStmt: {
+            const auto vardecl_stmt = bao::cast<bao::ast::VarDeclStmt>(stmt);
+            auto& var = vardecl_stmt->get_var();
+            auto type = var.get_type();
+            auto [var_line, var_column] = var.pos();
+            std::string var_name = "Biến";
+            if (var.is_const()) {
+                var_name = "Hằng";
+            }
+            cout << padding << " $ " << var_name << ": " << std::format(
+                    "{} ({}: {}) (Dòng {}, Cột {})",
+                    vardecl_stmt->get_var().get_name(),
+                    utils::type_to_string(type), type->get_name(),
+                    var_line, var_column
+                );
+            if (vardecl_stmt->get_val()) {
+                cout << " := " << endl;
+                ast::print_expression(vardecl_stmt->get_val(), padding + "   ");
+            }
             std::cout << std::endl;
+            break;
         }
-    } else if (const auto vardecl_stmt = dynamic_cast<bao::ast::VarDeclStmt*>(stmt)) {
-        auto& var = vardecl_stmt->get_var();
-        auto type = var.get_type();
-        auto [var_line, var_column] = var.pos();
-        std::string var_name = "Biến";
-        if (var.is_const()) {
-            var_name = "Hằng";
+        case bao::ast::NodeKind::VarAssignStmt: {
+            const auto varassign_stmt = bao::cast<bao::ast::VarAssignStmt>(stmt);
+            auto [line, column] = varassign_stmt->pos();
+            cout 
+                << padding << " $ "
+                << std::format(
+                    "{} ({}: {}) (Dòng {}, Cột {}) :=\n",
+                    varassign_stmt->get_var().get_name(),
+                    utils::type_to_string(varassign_stmt->get_var().get_type()),
+                    varassign_stmt->get_var().get_type()->get_name(),
+                    line, column
+                );
+            ast::print_expression(varassign_stmt->get_val(), padding + "   ");
+            std::cout << std::endl;
+            break;
         }
-        cout << padding << " $ " << var_name << ": " << std::format(
-                "{} ({}: {}) (Dòng {}, Cột {})",
-                vardecl_stmt->get_var().get_name(),
-                utils::type_to_string(type), type->get_name(),
-                var_line, var_column
-            );
-        if (vardecl_stmt->get_val()) {
-            cout << " := " << endl;
-            ast::print_expression(vardecl_stmt->get_val(), padding + "   ");
+        default: {
+            cout << padding + " ? Biểu thức không xác định";
+            std::cout << std::endl;
+            break;
         }
-        std::cout << std::endl;
-    } else if (const auto varassign_stmt = dynamic_cast<bao::ast::VarAssignStmt*>(stmt)) {
-        auto [line, column] = varassign_stmt->pos();
-        cout 
-            << padding << " $ "
-            << std::format(
-                "{} ({}: {}) (Dòng {}, Cột {}) :=\n",
-                varassign_stmt->get_var().get_name(),
-                utils::type_to_string(varassign_stmt->get_var().get_type()),
-                varassign_stmt->get_var().get_type()->get_name(),
-                line, column
-            );
-        ast::print_expression(varassign_stmt->get_val(), padding + "   ");
-        std::cout << std::endl;
-    } else {
-        cout << padding + " ? Biểu thức không xác định";
-        std::cout << std::endl;
     }
     std::cout << padding << std::endl;
 }
@@ -128,30 +157,42 @@ void bao::utils::ast::print_statement(bao::ast::StmtNode* stmt, const string &pa
 void bao::utils::ast::print_expression(bao::ast::ExprNode* expr, const string &padding) {
     auto [line, column] = expr->pos();
     std::string type = type_to_string(expr->get_type());
-    if (const auto num_expr = dynamic_cast<bao::ast::NumLitExpr*>(expr)) {
-        const auto message = std::format(
-            " $ Biểu thức số: {} ({}: {}) (Dòng {}, Cột {})",
-            num_expr->get_val(), type, num_expr->get_type()->get_name(), line, column
-        );
-        cout << pad_lines(message, padding);
-    } else if (const auto var_expr = dynamic_cast<bao::ast::VarExpr*>(expr)) {
-        const auto message = std::format(
-            " $ Biểu thức biến: {} ({}: {}) (Dòng {}, Cột {})",
-            var_expr->get_name(), type, var_expr->get_type()->get_name(), line, column
-        );
-        cout << pad_lines(message, padding);
-    } else if (const auto bin_expr = dynamic_cast<bao::ast::BinExpr*>(expr)){
-        const auto message = std::format(
-            " $ Biểu thức nhị phân ({}: {}) (Dòng {}, Cột {}):",
-            type, bin_expr->get_type()->get_name(), line, column
-        );
-        std::cout << pad_lines(message, padding) << std::endl;
-        print_expression(bin_expr->get_left(), padding + "   ");
-        std::cout << std::endl;
-        cout << padding + "      Phép toán: " + bin_expr->get_op() << std::endl;
-        print_expression(bin_expr->get_right(), padding + "   ");
-    } else {
-        cout << padding + " ? Biểu thức không xác định";
+    switch (expr->get_kind()) {
+        case bao::ast::NodeKind::NumLitExpr: {
+            const auto num_expr = bao::cast<bao::ast::NumLitExpr>(expr);
+            const auto message = std::format(
+                " $ Biểu thức số: {} ({}: {}) (Dòng {}, Cột {})",
+                num_expr->get_val(), type, num_expr->get_type()->get_name(), line, column
+            );
+            cout << pad_lines(message, padding);
+            break;
+        }
+        case bao::ast::NodeKind::VarExpr: {
+            const auto var_expr = bao::cast<bao::ast::VarExpr>(expr);
+            const auto message = std::format(
+                " $ Biểu thức biến: {} ({}: {}) (Dòng {}, Cột {})",
+                var_expr->get_name(), type, var_expr->get_type()->get_name(), line, column
+            );
+            cout << pad_lines(message, padding);
+            break;
+        }
+        case bao::ast::NodeKind::BinExpr: {
+            const auto bin_expr = bao::cast<bao::ast::BinExpr>(expr);
+            const auto message = std::format(
+                " $ Biểu thức nhị phân ({}: {}) (Dòng {}, Cột {}):",
+                type, bin_expr->get_type()->get_name(), line, column
+            );
+            std::cout << pad_lines(message, padding) << std::endl;
+            print_expression(bin_expr->get_left(), padding + "   ");
+            std::cout << std::endl;
+            cout << padding + "      Phép toán: " << bao::ast::bin_op_text(bin_expr->get_op()) << std::endl;
+            print_expression(bin_expr->get_right(), padding + "   ");
+            break;
+        }
+        default: {
+            cout << padding + " ? Biểu thức không xác định";
+            break;
+        }
     }
 }
 
@@ -167,7 +208,7 @@ void bao::utils::mir::print_module(const bao::mir::Module &module) {
 
 void bao::utils::mir::print_function(const bao::mir::Function &func, const string &padding) {
     cout << padding + "Hàm: " << func.name << endl;
-    cout << padding + "   Kiểu trả về: " << type_to_string(func.return_type.get()) << ": "<< func.return_type->get_name() << endl;
+    cout << padding + "   Kiểu trả về: " << type_to_string(func.return_type) << ": "<< func.return_type->get_name() << endl;
     /*
     cout << padding + "   Số tham số: " << func.parameters.size() << endl;
     for (const auto &param : func.parameters) {
@@ -188,87 +229,108 @@ void bao::utils::mir::print_block(const bao::mir::BasicBlock &block, const strin
 
 void bao::utils::mir::print_instruction(const bao::mir::Instruction* inst, const string &padding) {
     cout << padding;    
-    if (const auto alloc = dynamic_cast<const bao::mir::AllocInst*>(inst)) {
-        cout << "allocinst: ";
-        print_value(alloc->dst, "");
-    } else if (const auto store = dynamic_cast<const bao::mir::StoreInst*>(inst)) {
-        cout << "storeinst: ";
-        print_value(store->src, "");
-        cout << " -> ";
-        print_value(store->dst, "");
-    } else if (const auto load = dynamic_cast<const bao::mir::LoadInst*>(inst)) {
-        cout << "loadinst: ";
-        print_value(load->dst, "");
-        cout << " <- ";
-        print_value(load->src, "");
-    } else if (const auto call = dynamic_cast<const bao::mir::CallInst*>(inst)) {
-        cout << "callinst: ";
-        cout << "Tên hàm: " << call->function_name << endl;
-        cout << "Tham số: ";
-        for (const auto &arg : call->arguments) {
-            print_value(arg, "");
-        }
-    } else if (const auto ret = dynamic_cast<const bao::mir::ReturnInst*>(inst)) {
-        cout << "retinst: ";
-        print_value(ret->ret_val, "");
-    } else if (const auto bin = dynamic_cast<const bao::mir::BinInst*>(inst)) {
-        cout << "bininst: ";
-        cout << bin->dst.name << " = ";
-        switch(bin->op) {
-        case bao::mir::BinaryOp::Add_f:
-            cout << "add_f: ";
-            break;
-        case bao::mir::BinaryOp::Add_s:
-            cout << "add_c: ";
-            break;
-        case bao::mir::BinaryOp::Add_u:
-            cout << "add_u: ";
-            break;
-        case bao::mir::BinaryOp::Sub_f:
-            cout << "sub_f: ";
-            break;
-        case bao::mir::BinaryOp::Sub_s:
-            cout << "sub_c: ";
-            break;
-        case bao::mir::BinaryOp::Sub_u:
-            cout << "sub_u: ";
-            break;
-        case bao::mir::BinaryOp::Mul_f:
-            cout << "mul_f: ";
-            break;
-        case bao::mir::BinaryOp::Mul_s:
-            cout << "mul_c: ";
-            break;
-        case bao::mir::BinaryOp::Mul_u:
-            cout << "mul_u: ";
-            break;
-        case bao::mir::BinaryOp::Div_s:
-            cout << "div_s: ";
+    switch (inst->get_kind()) {
+        case bao::mir::InstKind::Alloc: {
+            const auto alloc = bao::cast<bao::mir::AllocInst>(inst);
+            cout << "allocinst: ";
+            print_value(alloc->dst, "");
             break;
-        case bao::mir::BinaryOp::Div_u:
-            cout << "div_u: ";
+        }
+        case bao::mir::InstKind::Store: {
+            const auto store = bao::cast<bao::mir::StoreInst>(inst);
+            cout << "storeinst: ";
+            print_value(store->src, "");
+            cout << " -> ";
+            print_value(store->dst, "");
             break;
-        case bao::mir::BinaryOp::Div_f:
-            cout << "div_f: ";
+        }
+        case bao::mir::InstKind::Load: {
+            const auto load = bao::cast<bao::mir::LoadInst>(inst);
+            cout << "loadinst: ";
+            print_value(load->dst, "");
+            cout << " <- ";
+            print_value(load->src, "");
             break;
-        case bao::mir::BinaryOp::Rem_s:
-            cout << "rem_s: ";
+        }
+        case bao::mir::InstKind::Call: {
+            const auto call = bao::cast<bao::mir::CallInst>(inst);
+            cout << "callinst: ";
+            cout << "Tên hàm: " << call->function_name << endl;
+            cout << "Tham số: ";
+            for (const auto &arg : call->arguments) {
+                print_value(arg, "");
+            }
             break;
-        case bao::mir::BinaryOp::Rem_u:
-            cout << "rem_u: ";
+        }
+        case bao::mir::InstKind::Return: {
+            const auto ret = bao::cast<bao::mir::ReturnInst>(inst);
+            cout << "retinst: ";
+            print_value(ret->ret_val, "");
             break;
-        case bao::mir::BinaryOp::Lt_s:
-            cout << "lt_s: ";
+        }
+        case bao::mir::InstKind::Bin: {
+            const auto bin = bao::cast<bao::mir::BinInst>(inst);
+            cout << "bininst: ";
+            cout << bin->dst.get_name() << " = ";
+            switch(bin->op) {
+            case bao::mir::BinaryOp::Add_f:
+                cout << "add_f: ";
+                break;
+            case bao::mir::BinaryOp::Add_s:
+                cout << "add_c: ";
+                break;
+            case bao::mir::BinaryOp::Add_u:
+                cout << "add_u: ";
+                break;
+            case bao::mir::BinaryOp::Sub_f:
+                cout << "sub_f: ";
+                break;
+            case bao::mir::BinaryOp::Sub_s:
+                cout << "sub_c: ";
+                break;
+            case bao::mir::BinaryOp::Sub_u:
+                cout << "sub_u: ";
+                break;
+            case bao::mir::BinaryOp::Mul_f:
+                cout << "mul_f: ";
+                break;
+            case bao::mir::BinaryOp::Mul_s:
+                cout << "mul_c: ";
+                break;
+            case bao::mir::BinaryOp::Mul_u:
+                cout << "mul_u: ";
+                break;
+            case bao::mir::BinaryOp::Div_s:
+                cout << "div_s: ";
+                break;
+            case bao::mir::BinaryOp::Div_u:
+                cout << "div_u: ";
+                break;
+            case bao::mir::BinaryOp::Div_f:
+                cout << "div_f: ";
+                break;
+            case bao::mir::BinaryOp::Rem_s:
+                cout << "rem_s: ";
+                break;
+            case bao::mir::BinaryOp::Rem_u:
+                cout << "rem_u: ";
+                break;
+            case bao::mir::BinaryOp::Lt_s:
+                cout << "lt_s: ";
+                break;
+            case bao::mir::BinaryOp::Lt_u:
+                cout << "lt_u: ";
+                break;
+            }
+            print_value(bin->left, "");
+            cout << ", ";
+            print_value(bin->right, "");
             break;
-        case bao::mir::BinaryOp::Lt_u:
-            cout << "lt_u: ";
+        }
+        default: {
+            cout << "Lệnh không xác định";
             break;
         }
-        print_value(bin->left, "");
-        cout << ", ";
-        print_value(bin->right, "");
-    } else {
-        cout << "Lệnh không xác định";
     }
     cout << endl;
 }
@@ -279,25 +341,25 @@ void bao::utils::mir::print_value(const bao::mir::Value &value, const string &pa
         case bao::mir::ValueKind::Constant:
             cout << std::format(
                 "const({}<{}> {})",
-                type_to_string(value.type.get()),
+                type_to_string(value.type),
                 value.type->get_name(),
-                value.name
+                value.get_name()
             );
             break;
         case bao::mir::ValueKind::Temporary:
             cout << std::format(
                 "temp({}<{}> {})",
-                type_to_string(value.type.get()),
+                type_to_string(value.type),
                 value.type->get_name(),
-                value.name
+                value.get_name()
             );
             break;
         case bao::mir::ValueKind::Variable:
             cout << std::format(
                 "var({}<{}> {})",
-                type_to_string(value.type.get()),
+                type_to_string(value.type),
                 value.type->get_name(),
-                value.name
+                value.get_name()
             );
             break;
         default:
@@ -306,17 +368,6 @@ void bao::utils::mir::print_value(const bao::mir::Value &value, const string &pa
     }
 }
 
-void bao::utils::match(
-    const string& val,
-    const std::unordered_map<string, std::function<void()>>& pattern,
-    const std::function<void()>& default_case) {
-    if (pattern.contains(val)) {
-        pattern.at(val)();
-    } else {
-       default_case();
-    }
-}
-
 string bao::utils::pad_lines(const string &input, const string &padding) {
     istringstream iss(input);
     ostringstream oss;
@@ -332,25 +383,42 @@ string bao::utils::pad_lines(const string &input, const string &padding) {
 }
 
 bool bao::utils::is_literal(bao::ast::ExprNode* expr) {
-    // Null check
-    if (!expr) {
-        return false;
-    }
-    if (dynamic_cast<bao::ast::NumLitExpr*>(expr)) {
-        return true;
-    }
-    if (auto bin_expr = dynamic_cast<bao::ast::BinExpr*>(expr)) {
-        return is_literal(bin_expr->get_left()) && is_literal(bin_expr->get_right());
+    // Walk over an explicit stack, expressions can nest deeper than the native stack
+    vector<bao::ast::ExprNode*> pending{expr};
+    while (!pending.empty()) {
+        bao::ast::ExprNode* node = pending.back();
+        pending.pop_back();
+        // Null check
+        if (!node) {
+            return false;
+        }
+        switch (node->get_kind()) {
+            case bao::ast::NodeKind::NumLitExpr:
+                break;
+            case bao::ast::NodeKind::BinExpr: {
+                const auto bin_expr = bao::cast<bao::ast::BinExpr>(node);
+                pending.push_back(bin_expr->get_right());
+                pending.push_back(bin_expr->get_left());
+                break;
+            }
+            default:
+                return false;
+        }
     }
-    return false;
+    return true;
 }
 
-void bao::utils::cast_literal(bao::ast::ExprNode *expr, Type *type) {
+void bao::utils::cast_literal(bao::ast::ExprNode *expr, const Type *type) {
     try {
-        expr->set_type(type->clone());
-        if (auto bin_expr = dynamic_cast<bao::ast::BinExpr*>(expr)) {
-            bao::utils::cast_literal(bin_expr->get_left(), type);
-            bao::utils::cast_literal(bin_expr->get_right(), type);
+        vector<bao::ast::ExprNode*> pending{expr};
+        while (!pending.empty()) {
+            bao::ast::ExprNode* node = pending.back();
+            pending.pop_back();
+            node->set_type(type);
+            if (auto bin_expr = bao::dyn_cast<bao::ast::BinExpr>(node)) {
+                pending.push_back(bin_expr->get_right());
+                pending.push_back(bin_expr->get_left());
+            }
         }
     } catch (...) {
         throw std::runtime_error(std::format("Lỗi nội bộ: Không nhận dạng được kiểu chuyển: {}", type->get_name()));
@@ -361,36 +429,28 @@ bool bao::utils::can_cast_literal(const bao::ast::ExprNode *expr, const Type *ty
     if (!expr->get_type()) {
         return false;
     }
-    const auto prim = dynamic_cast<PrimitiveType*>(expr->get_type());
+    const auto prim = bao::dyn_cast<PrimitiveType>(expr->get_type());
     if (!prim) {
         return false; // FIXME: Handle this case
     }
+    const TypeContext& types = TypeContext::builtins();
     switch (prim->get_type()) {
         case Primitive::N64:
         case Primitive::N32:
-            if (type->get_name() == "N32") {
-                return true;
-            }
-            return false;
+            return type == types.primitive(Primitive::N32);
         case Primitive::Z64:
         case Primitive::Z32:
-            if (type->get_name() == "Z32") {
-                return true;
-            }
-            return false;
+            return type == types.primitive(Primitive::Z32);
         case Primitive::R64:
         case Primitive::R32:
-            if (type->get_name() == "R32") {
-                return true;
-            }
-            return false;
+            return type == types.primitive(Primitive::R32);
         default:
             return false;
     }
 }
 
-llvm::Type* bao::utils::get_llvm_type(llvm::IRBuilder<> &builder, bao::Type* type) {
-    if (auto prim = dynamic_cast<bao::PrimitiveType*>(type)) {
+llvm::Type* bao::utils::get_llvm_type(llvm::IRBuilder<> &builder, const bao::Type* type) {
+    if (auto prim = bao::dyn_cast<bao::PrimitiveType>(type)) {
         switch (prim->get_type()) {
         // LLVM does not differentiate signed and unsigned types
         case bao::Primitive::N32:
@@ -414,14 +474,18 @@ llvm::Type* bao::utils::get_llvm_type(llvm::IRBuilder<> &builder, bao::Type* typ
     throw std::runtime_error(std::format("-> Lỗi nội bộ: Không thể chuyển kiểu: {}", type->get_name()));
 }
 
-std::string bao::utils::type_to_string(Type *type) {
-    if (auto prim = dynamic_cast<PrimitiveType*>(type)) {
-        return "PrimitiveType";
-    } else if (auto unknown = dynamic_cast<UnknownType*>(type)) {
-        return "Unknown";
-    } else {
+std::string bao::utils::type_to_string(const Type *type) {
+    if (!type) {
         return "__error";
     }
+    switch (type->get_kind()) {
+        case TypeKind::Primitive:
+            return "PrimitiveType";
+        case TypeKind::Unknown:
+            return "Unknown";
+        default:
+            return "__error";
+    }
 }
 
 // Helper function guide Linux into the program
@@ -548,22 +612,23 @@ void bao::utils::trim(std::string& str) {
     }
 }
 
-bool bao::utils::is_signed(bao::Type* type) {
-    const auto type_name = type->get_name();
-    std::vector<std::string> valid = {"Z32", "Z64", "R32", "R64"};
-    if (std::any_of(valid.begin(), valid.end(), 
-        [&](const std::string& s) { return s == type_name; })) {
-        return true;
+bool bao::utils::is_signed(const bao::Type* type) {
+    const auto prim = bao::dyn_cast<PrimitiveType>(type);
+    if (!prim) {
+        return false;
+    }
+    switch (prim->get_type()) {
+        case Primitive::Z32:
+        case Primitive::Z64:
+        case Primitive::R32:
+        case Primitive::R64:
+            return true;
+        default:
+            return false;
     }
-    return false;
 }
 
-bool bao::utils::is_float(bao::Type* type) {
-    const auto type_name = type->get_name();
-    std::vector<std::string> valid = {"R32", "R64"};
-    if (std::any_of(valid.begin(), valid.end(), 
-        [&](const std::string& s) { return s == type_name; })) {
-        return true;
-    }
-    return false;
+bool bao::utils::is_float(const bao::Type* type) {
+    const auto prim = bao::dyn_cast<PrimitiveType>(type);
+    return prim && (prim->get_type() == Primitive::R32 || prim->get_type() == Primitive::R64);
 }
\ No newline at end of file
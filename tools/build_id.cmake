@@ -0,0 +1,28 @@
+# Writes the build ID of the compiler, a hash of every source that goes into
+# the binary and of the toolchain building it. Runs on every build, the header
+# is only rewritten when the ID changes
+#   cmake -DSOURCE_DIR=<repo> -DOUTPUT=<header> -DTOOLCHAIN=<text> -P build_id.cmake
+file(GLOB_RECURSE BAO_SOURCES
+    ${SOURCE_DIR}/src/*.cpp
+    ${SOURCE_DIR}/include/*.h
+    ${SOURCE_DIR}/tools/*.cpp
+)
+list(APPEND BAO_SOURCES ${SOURCE_DIR}/main.cpp ${SOURCE_DIR}/CMakeLists.txt)
+list(SORT BAO_SOURCES)
+
+set(BAO_BUILD_INPUT "${TOOLCHAIN}")
+foreach(SOURCE IN LISTS BAO_SOURCES)
+    file(RELATIVE_PATH SOURCE_NAME ${SOURCE_DIR} ${SOURCE})
+    file(SHA256 ${SOURCE} SOURCE_HASH)
+    string(APPEND BAO_BUILD_INPUT "\n${SOURCE_NAME} ${SOURCE_HASH}")
+endforeach()
+string(SHA256 BAO_BUILD_ID "${BAO_BUILD_INPUT}")
+string(SUBSTRING ${BAO_BUILD_ID} 0 16 BAO_BUILD_ID)
+
+file(CONFIGURE OUTPUT ${OUTPUT} CONTENT [[
+#ifndef BUILD_ID_H
+#define BUILD_ID_H
+// Generated by tools/build_id.cmake, do not edit
+#define BAO_BUILD_ID 0x@BAO_BUILD_ID@ull
+#endif //BUILD_ID_H
+]] @ONLY)
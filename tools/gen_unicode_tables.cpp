@@ -0,0 +1,68 @@
+// Generates the Unicode property tables of the lexer from the ICU the compiler is built with
+#include <bao/lexer/unicode.h>
+#include <unicode/uchar.h>
+#include <unicode/uversion.h>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <vector>
+
+using bao::unicode::BLOCK_SIZE;
+using bao::unicode::CODE_POINT_LIMIT;
+
+int main(const int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "Cú pháp: gen_unicode_tables <tệp đầu ra>" << std::endl;
+        return 1;
+    }
+
+    std::vector<uint16_t> index;
+    std::vector<std::vector<uint8_t>> blocks;
+    std::map<std::vector<uint8_t>, uint16_t> block_ids;
+    for (UChar32 start = 0; start < CODE_POINT_LIMIT; start += BLOCK_SIZE) {
+        std::vector<uint8_t> block(BLOCK_SIZE);
+        for (UChar32 i = 0; i < BLOCK_SIZE; i++) {
+            const UChar32 cp = start + i;
+            uint8_t bits = 0;
+            if (u_hasBinaryProperty(cp, UCHAR_XID_START)) {
+                bits |= bao::unicode::XID_START;
+            }
+            if (u_hasBinaryProperty(cp, UCHAR_XID_CONTINUE)) {
+                bits |= bao::unicode::XID_CONTINUE;
+            }
+            if (u_charType(cp) == U_DECIMAL_DIGIT_NUMBER) {
+                bits |= bao::unicode::DIGIT;
+            }
+            block[i] = bits;
+        }
+        const auto [it, inserted] = block_ids.emplace(block, static_cast<uint16_t>(blocks.size()));
+        if (inserted) {
+            blocks.push_back(std::move(block));
+        }
+        index.push_back(it->second);
+    }
+
+    std::ofstream out(argv[1]);
+    if (!out) {
+        std::cerr << "Lỗi: không thể ghi tệp " << argv[1] << std::endl;
+        return 1;
+    }
+    out << "// Generated by tools/gen_unicode_tables.cpp from Unicode " << U_UNICODE_VERSION << ", do not edit\n";
+    out << "#include <bao/lexer/unicode.h>\n\n";
+    out << "namespace bao::unicode::tables {\n";
+    out << "    const uint16_t index[CODE_POINT_LIMIT >> BLOCK_SHIFT] = {";
+    for (size_t i = 0; i < index.size(); i++) {
+        out << (i % 16 == 0 ? "\n        " : " ") << index[i] << ",";
+    }
+    out << "\n    };\n\n";
+    out << "    const uint8_t blocks[] = {";
+    for (size_t b = 0; b < blocks.size(); b++) {
+        for (size_t i = 0; i < blocks[b].size(); i++) {
+            out << (i % 32 == 0 ? "\n        " : " ") << static_cast<int>(blocks[b][i]) << ",";
+        }
+    }
+    out << "\n    };\n";
+    out << "}\n";
+    return out.good() ? 0 : 1;
+}